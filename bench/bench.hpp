@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+
+#include <banner/core/types.hpp>
+#include <banner/util/time.hpp>
+
+namespace bnr {
+namespace bench {
+struct result
+{
+    str name;
+    u32 entities;
+    u32 samples;
+
+    // Median of the samples
+    f64 total_ns;
+    f64 ns_per_entity;
+};
+
+/**
+ * @brief Times `f` & returns the elapsed nanoseconds.
+ */
+template<typename F>
+f64 time(F&& f)
+{
+    const auto start = clock::now();
+    f();
+    return f64(duration_cast<std::chrono::nanoseconds>(clock::now() - start).count());
+}
+
+/**
+ * @brief Calls `f` once to warm up then `samples` times & keeps the median, `f`
+ * returns the nanoseconds it measured so it can leave its setup out.
+ */
+template<typename F>
+result run(str name, u32 entities, u32 samples, F&& f)
+{
+    f();
+
+    vector<f64> times(samples);
+    for (auto& t : times) {
+        t = f();
+    }
+
+    std::sort(times.begin(), times.end());
+    const auto median = times[times.size() / 2];
+
+    const auto per_entity = median / std::max(entities, 1u);
+
+    return { std::move(name), entities, samples, median, per_entity };
+}
+
+inline void write_csv(std::ostream& out, const vector<result>& results)
+{
+    out << "name,entities,samples,total_ns,ns_per_entity\n";
+
+    for (const auto& r : results) {
+        out << r.name << ',' << r.entities << ',' << r.samples << ',' << r.total_ns << ','
+            << r.ns_per_entity << '\n';
+    }
+}
+
+inline void write_json(std::ostream& out, const vector<result>& results)
+{
+    out << "[\n";
+
+    for (u32 i = 0; i < results.size(); i++) {
+        const auto& r = results[i];
+        out << "  { \"name\": \"" << r.name << "\", \"entities\": " << r.entities
+            << ", \"samples\": " << r.samples << ", \"total_ns\": " << r.total_ns
+            << ", \"ns_per_entity\": " << r.ns_per_entity << " }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "]\n";
+}
+
+/**
+ * @brief Reads results written by `write_csv`.
+ */
+inline vector<result> read_csv(std::istream& in)
+{
+    vector<result> results;
+    str line;
+
+    // Skip the header
+    std::getline(in, line);
+
+    while (std::getline(in, line)) {
+        std::istringstream fields{ line };
+        result r;
+        str field;
+
+        if (!std::getline(fields, r.name, ','))
+            continue;
+
+        std::getline(fields, field, ',');
+        r.entities = u32(std::strtoul(field.c_str(), nullptr, 10));
+        std::getline(fields, field, ',');
+        r.samples = u32(std::strtoul(field.c_str(), nullptr, 10));
+        std::getline(fields, field, ',');
+        r.total_ns = std::strtod(field.c_str(), nullptr);
+        std::getline(fields, field, ',');
+        r.ns_per_entity = std::strtod(field.c_str(), nullptr);
+
+        results.push_back(std::move(r));
+    }
+
+    return results;
+}
+
+/**
+ * @brief Prints the results that got slower than `baseline` by more than
+ * `tolerance` (0.1 = 10%) & returns how many there are.
+ */
+inline u32 compare(const vector<result>& baseline, const vector<result>& results,
+    f64 tolerance)
+{
+    u32 regressions{ 0 };
+
+    for (const auto& r : results) {
+        const auto old =
+            std::find_if(baseline.begin(), baseline.end(), [&](const auto& b) {
+                return b.name == r.name && b.entities == r.entities;
+            });
+
+        if (old == baseline.end() || old->total_ns <= 0.0)
+            continue;
+
+        const auto ratio = r.total_ns / old->total_ns;
+
+        if (ratio > 1.0 + tolerance) {
+            std::fprintf(stderr, "regression: %s @ %u entities, %.2fx slower\n",
+                r.name.c_str(), r.entities, ratio);
+            regressions++;
+        }
+    }
+
+    return regressions;
+}
+
+struct config
+{
+    str format{ "csv" };
+    str out;
+    str baseline;
+    u32 samples{ 9 };
+    f64 tolerance{ 0.1 };
+
+    // Problem sizes to sweep, entities, calls, ...
+    vector<u32> counts;
+};
+
+/**
+ * @brief Parses the options every benchmark takes, `counts` are the defaults for
+ * `--counts`.
+ *
+ * usage: [--format csv|json] [--out path] [--samples n] [--counts 1000,10000]
+ *        [--baseline path] [--tolerance 0.1]
+ */
+inline config parse(int argc, char** argv, vector<u32> counts)
+{
+    config cfg;
+    cfg.counts = std::move(counts);
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string_view key{ argv[i] };
+        const str value{ argv[i + 1] };
+
+        if (key == "--format") {
+            cfg.format = value;
+        } else if (key == "--out") {
+            cfg.out = value;
+        } else if (key == "--baseline") {
+            cfg.baseline = value;
+        } else if (key == "--samples") {
+            cfg.samples = std::max(1u, u32(std::strtoul(value.c_str(), nullptr, 10)));
+        } else if (key == "--tolerance") {
+            cfg.tolerance = std::strtod(value.c_str(), nullptr);
+        } else if (key == "--counts") {
+            cfg.counts.clear();
+            std::istringstream list{ value };
+            for (str n; std::getline(list, n, ',');) {
+                cfg.counts.push_back(u32(std::strtoul(n.c_str(), nullptr, 10)));
+            }
+        } else {
+            std::fprintf(stderr, "unknown option %s\n", argv[i]);
+        }
+    }
+
+    return cfg;
+}
+
+/**
+ * @brief Writes `results` as configured & compares them to the baseline, returns the
+ * exit code: non zero when something regressed.
+ */
+inline int report(const config& cfg, const vector<result>& results)
+{
+    std::ofstream file;
+    if (!cfg.out.empty()) {
+        file.open(cfg.out);
+    }
+    auto& out = file.is_open() ? static_cast<std::ostream&>(file) : std::cout;
+
+    if (cfg.format == "json") {
+        write_json(out, results);
+    } else {
+        write_csv(out, results);
+    }
+
+    if (cfg.baseline.empty())
+        return 0;
+
+    std::ifstream baseline{ cfg.baseline };
+    if (!baseline) {
+        std::fprintf(stderr, "couldn't open baseline %s\n", cfg.baseline.c_str());
+        return 1;
+    }
+
+    return compare(read_csv(baseline), results, cfg.tolerance) ? 1 : 0;
+}
+} // namespace bench
+} // namespace bnr
@@ -0,0 +1,150 @@
+#include <cstring>
+
+#include <banner/core/culling.hpp>
+#include <banner/gfx/render_list.hpp>
+#include <banner/util/frame_arena.hpp>
+#include <banner/util/random.hpp>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+#include "bench.hpp"
+
+using namespace bnr;
+
+/*
+    Frustum culling of packed render lists, `--counts` are the draws per sample.
+
+    render_list/cull is what the renderer pays per frame: mesh bounds moved to world
+    space & tested in registers, then the visible draws compacted. culling/boxes is
+    the kernel alone on prepared world space arrays. Build with BANNER_AVX2 to compare
+    the AVX2 path against the default SSE one.
+
+    usage: banner_bench_culling [--format csv|json] [--out path] [--samples n]
+                                [--counts 10000,100000] [--baseline path]
+                                [--tolerance 0.1]
+*/
+
+namespace {
+constexpr u32 mesh_count = 16;
+
+// Keeps results alive so the optimizer can't drop the work
+volatile u32 sink;
+
+struct scene
+{
+    vector<u32> meshes;
+    vector<mat4> transforms;
+    vector<aabb> bounds;
+    frustum view;
+};
+
+// Draws scattered in a 200 unit cube in front of the camera, about a third visible
+scene make_scene(u32 count)
+{
+    scene s;
+    s.meshes.resize(count);
+    s.transforms.resize(count);
+
+    for (u32 m = 0; m < mesh_count; m++) {
+        const auto half = rnd(0.25f, 2.f);
+        s.bounds.push_back({ v3{ -half }, v3{ half } });
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        const v3 position{ rnd(-100.f, 100.f), rnd(-100.f, 100.f), rnd(-100.f, 100.f) };
+        const auto model = glm::translate(mat4{ 1.f }, position);
+
+        s.meshes[i] = u32(rand()) % mesh_count;
+        s.transforms[i] = glm::scale(model, v3{ rnd(0.5f, 2.f) });
+    }
+
+    const auto projection = glm::perspective(glm::radians(60.f), 16.f / 9.f, 0.1f, 500.f);
+    const auto camera = glm::translate(mat4{ 1.f }, v3{ 0.f, 0.f, -120.f });
+    s.view = frustum::from(projection * camera);
+
+    return s;
+}
+
+render_list make_list(const scene& s, frame_arena& arena)
+{
+    render_list list;
+    list.count = u32(s.meshes.size());
+    list.meshes = arena.allocate<u32>(list.count);
+    list.materials = arena.allocate<u32>(list.count);
+    list.transforms = arena.allocate<mat4>(list.count);
+    list.keys = arena.allocate<u64>(list.count);
+
+    std::memcpy(list.meshes, s.meshes.data(), list.count * sizeof(u32));
+    std::memcpy(list.transforms, s.transforms.data(), list.count * sizeof(mat4));
+
+    for (u32 i = 0; i < list.count; i++) {
+        list.materials[i] = 0;
+        list.keys[i] = render_list::sort_key(0, list.meshes[i]);
+    }
+
+    return list;
+}
+
+void cull_list(vector<bench::result>& results, const scene& s, u32 samples)
+{
+    const auto count = u32(s.meshes.size());
+    frame_arena arena;
+
+    results.push_back(bench::run("render_list/cull", count, samples, [&]() {
+        // Refilled every sample since culling compacts the list
+        arena.reset();
+        auto list = make_list(s, arena);
+
+        const auto ns = bench::time([&]() { list.cull(s.view, s.bounds, arena); });
+        sink = list.count;
+        return ns;
+    }));
+}
+
+void cull_boxes(vector<bench::result>& results, const scene& s, u32 samples)
+{
+    const auto count = u32(s.meshes.size());
+
+    vector<f32> soa[6];
+    for (auto& array : soa) {
+        array.resize(count);
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        const auto box = s.bounds[s.meshes[i]].transformed(s.transforms[i]);
+        const auto center = box.center();
+        const auto extent = box.extent();
+
+        for (u32 axis = 0; axis < 3; axis++) {
+            soa[axis][i] = center[axis];
+            soa[3 + axis][i] = extent[axis];
+        }
+    }
+
+    const culling::boxes boxes{ soa[0].data(), soa[1].data(), soa[2].data(),
+        soa[3].data(), soa[4].data(), soa[5].data() };
+    vector<u32> visible(count);
+
+    results.push_back(bench::run("culling/boxes", count, samples, [&]() {
+        return bench::time(
+            [&]() { sink = culling::cull(s.view, boxes, count, visible.data()); });
+    }));
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto cfg = bench::parse(argc, argv, { 10000, 100000 });
+
+    vector<bench::result> results;
+
+    for (const auto count : cfg.counts) {
+        srand(count);
+        const auto s = make_scene(count);
+
+        cull_list(results, s, cfg.samples);
+        cull_boxes(results, s, cfg.samples);
+    }
+
+    return bench::report(cfg, results);
+}
@@ -0,0 +1,174 @@
+#include <utility>
+
+#include <banner/core/jobs.hpp>
+#include <banner/entity/entity.hpp>
+#include <banner/entity/scheduler.hpp>
+
+#include "bench.hpp"
+
+using namespace bnr;
+
+/*
+    Benchmarks for the realm world operations the engine relies on, rerun them with
+    `--baseline` against a previous run whenever the realm submodule is bumped.
+
+    usage: banner_bench [--format csv|json] [--out path] [--samples n]
+                        [--counts 1000,10000,100000] [--baseline path] [--tolerance 0.1]
+*/
+
+namespace {
+template<u32 N>
+struct comp
+{
+    f32 value{ 1.f };
+};
+
+// Keeps results alive so the optimizer can't drop the work
+volatile f32 sink;
+
+template<u32... I>
+void create_all(world& w, u32 count, std::integer_sequence<u32, I...>)
+{
+    for (u32 i = 0; i < count; i++) {
+        w.create(comp<I>{}...);
+    }
+}
+
+template<u32... I>
+f32 iterate(world& w, std::integer_sequence<u32, I...>)
+{
+    f32 sum{ 0.f };
+    query(&w, [&](const comp<I>&... c) { sum += (c.value + ...); });
+    return sum;
+}
+
+struct integrate
+{
+    void update(comp<0>& position, const comp<1>& velocity) const
+    {
+        position.value += velocity.value * 0.016f;
+    }
+};
+
+struct damp
+{
+    void update(comp<2>& velocity) const { velocity.value *= 0.99f; }
+};
+
+struct age
+{
+    void update(comp<3>& lifetime, const comp<4>& rate) const
+    {
+        lifetime.value -= rate.value;
+    }
+};
+
+void entities(vector<bench::result>& results, u32 count, u32 samples)
+{
+    results.push_back(bench::run("create", count, samples, [&]() {
+        world w{ count };
+        return bench::time(
+            [&]() { create_all(w, count, std::make_integer_sequence<u32, 2>{}); });
+    }));
+
+    results.push_back(bench::run("destroy", count, samples, [&]() {
+        world w{ count };
+        vector<entity> created(count);
+        for (auto& e : created) {
+            e = w.create(comp<0>{}, comp<1>{});
+        }
+
+        return bench::time([&]() {
+            for (auto e : created) {
+                w.destroy(e);
+            }
+        });
+    }));
+}
+
+void components(vector<bench::result>& results, u32 count, u32 samples)
+{
+    // Both move every entity to another archetype
+    results.push_back(bench::run("add", count, samples, [&]() {
+        world w{ count };
+        vector<entity> created(count);
+        for (auto& e : created) {
+            e = w.create(comp<0>{});
+        }
+
+        return bench::time([&]() {
+            for (auto e : created) {
+                w.add<comp<1>>(e, comp<1>{});
+            }
+        });
+    }));
+
+    results.push_back(bench::run("remove", count, samples, [&]() {
+        world w{ count };
+        vector<entity> created(count);
+        for (auto& e : created) {
+            e = w.create(comp<0>{}, comp<1>{});
+        }
+
+        return bench::time([&]() {
+            for (auto e : created) {
+                w.remove<comp<1>>(e);
+            }
+        });
+    }));
+}
+
+template<u32... K>
+void queries(vector<bench::result>& results, u32 count, u32 samples,
+    std::integer_sequence<u32, K...>)
+{
+    world w{ count };
+    create_all(w, count, std::make_integer_sequence<u32, 8>{});
+
+    auto query_k = [&](auto k) {
+        constexpr u32 components = decltype(k)::value;
+        results.push_back(bench::run(
+            "query/" + std::to_string(components), count, samples, [&]() {
+                return bench::time([&]() {
+                    sink = iterate(w, std::make_integer_sequence<u32, components>{});
+                });
+            }));
+    };
+
+    (query_k(std::integral_constant<u32, K + 1>{}), ...);
+}
+
+void systems(vector<bench::result>& results, u32 count, u32 samples, bnr::jobs* jobs)
+{
+    world w{ count };
+    create_all(w, count, std::make_integer_sequence<u32, 5>{});
+
+    for (const bool parallel : { false, true }) {
+        scheduler s{ &w, jobs, { parallel, 4096 } };
+        s.insert<integrate>();
+        s.insert<damp>();
+        s.insert<age>();
+
+        results.push_back(bench::run(parallel ? "systems/parallel" : "systems/serial",
+            count, samples, [&]() { return bench::time([&]() { s.update(); }); }));
+    }
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    // Sweeps up to the engine's default world size
+    const auto cfg = bench::parse(argc, argv, { 1000, 10000, 100000 });
+
+    bnr::jobs jobs{ 0 };
+    vector<bench::result> results;
+
+    for (const auto count : cfg.counts) {
+        entities(results, count, cfg.samples);
+        components(results, count, cfg.samples);
+        queries(results, count, cfg.samples, std::make_integer_sequence<u32, 8>{});
+        systems(results, count, cfg.samples, &jobs);
+    }
+
+    return bench::report(cfg, results);
+}
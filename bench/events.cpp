@@ -0,0 +1,143 @@
+#include <banner/util/event.hpp>
+#include <banner/util/signal.hpp>
+
+#include "bench.hpp"
+
+using namespace bnr;
+
+/*
+    Dispatch cost of the compile time event bus against the Nano signals it replaces,
+    `--counts` are the calls per sample.
+
+    usage: banner_bench_events [--format csv|json] [--out path] [--samples n]
+                               [--counts 1000,100000] [--baseline path] [--tolerance 0.1]
+*/
+
+namespace {
+constexpr u32 max_listeners = 16;
+constexpr u32 batch = 256;
+
+using resize_bus = event_bus<event<"resize", void(u16, u16), max_listeners, batch>>;
+
+struct listener
+{
+    u32 sum{ 0 };
+
+    void resize(u16 w, u16 h) { sum += w + h; }
+};
+
+// Keeps results alive so the optimizer can't drop the work
+volatile u32 sink;
+
+u32 total(const vector<listener>& listeners)
+{
+    u32 sum{ 0 };
+    for (const auto& l : listeners) {
+        sum += l.sum;
+    }
+    return sum;
+}
+
+void fire(vector<bench::result>& results, u32 calls, u32 listeners, u32 samples)
+{
+    const auto suffix = "/" + std::to_string(listeners);
+    vector<listener> targets(listeners);
+
+    {
+        signal<void(u16, u16)> nano;
+        for (auto& l : targets) {
+            nano.connect<&listener::resize>(l);
+        }
+
+        results.push_back(bench::run("nano/fire" + suffix, calls, samples, [&]() {
+            return bench::time([&]() {
+                for (u32 i = 0; i < calls; i++) {
+                    nano.fire(u16(i), u16(i));
+                }
+            });
+        }));
+    }
+
+    resize_bus bus;
+    for (auto& l : targets) {
+        bus.on<"resize", &listener::resize>(l);
+    }
+
+    results.push_back(bench::run("bus/fire" + suffix, calls, samples, [&]() {
+        return bench::time([&]() {
+            for (u32 i = 0; i < calls; i++) {
+                bus.fire<"resize">(u16(i), u16(i));
+            }
+        });
+    }));
+
+    // Batches of queued calls delivered by one dispatch
+    results.push_back(bench::run("bus/dispatch" + suffix, calls, samples, [&]() {
+        return bench::time([&]() {
+            for (u32 i = 0; i < calls; i++) {
+                bus.queue<"resize">(u16(i), u16(i));
+
+                if (bus.queued<"resize">() == batch) {
+                    bus.dispatch();
+                }
+            }
+            bus.dispatch();
+        });
+    }));
+
+    sink = total(targets);
+}
+
+void connect(vector<bench::result>& results, u32 calls, u32 samples)
+{
+    vector<listener> targets(max_listeners);
+    const auto rounds = std::max(calls / max_listeners, 1u);
+
+    // Connects & disconnects every listener, Nano allocates its connections
+    signal<void(u16, u16)> nano;
+
+    results.push_back(bench::run("nano/connect", rounds * max_listeners, samples, [&]() {
+        return bench::time([&]() {
+            for (u32 r = 0; r < rounds; r++) {
+                for (auto& l : targets) {
+                    nano.connect<&listener::resize>(l);
+                }
+                for (auto& l : targets) {
+                    nano.disconnect<&listener::resize>(l);
+                }
+            }
+        });
+    }));
+
+    resize_bus bus;
+
+    results.push_back(bench::run("bus/connect", rounds * max_listeners, samples, [&]() {
+        return bench::time([&]() {
+            for (u32 r = 0; r < rounds; r++) {
+                for (auto& l : targets) {
+                    bus.on<"resize", &listener::resize>(l);
+                }
+                for (auto& l : targets) {
+                    bus.off<"resize", &listener::resize>(l);
+                }
+            }
+        });
+    }));
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    const auto cfg = bench::parse(argc, argv, { 1000, 100000 });
+
+    vector<bench::result> results;
+
+    for (const auto calls : cfg.counts) {
+        for (const u32 listeners : { 1u, 4u, max_listeners }) {
+            fire(results, calls, listeners, cfg.samples);
+        }
+        connect(results, calls, cfg.samples);
+    }
+
+    return bench::report(cfg, results);
+}
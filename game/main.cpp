@@ -24,7 +24,7 @@ int main()
         engine->on_init = [&]() {
             // Insert system
             engine->world()->create<v2>();
-            engine->world()->insert<example_system>();
+            engine->systems()->insert<example_system>();
 
             // Init triangle pipeline
             auto ctx = engine->graphics();
@@ -42,11 +42,13 @@ int main()
             pipeline->add_fragment_shader(
                 "main", ctx->load_shader("shaders/shader.frag.spv"));
 
-            auto mesh = make_quad(ctx);
+            pipeline->add_push_constant(vk::ShaderStageFlagBits::eVertex, sizeof(mat4));
 
-            pipeline->on_process = [&, mesh](vk::CommandBuffer cmd_buf) {
-                mesh->draw(cmd_buf);
-            };
+            // Draw a quad through the render list
+            auto mesh = engine->renderer()->add_mesh(make_quad(ctx));
+            auto material = engine->renderer()->add_material(pipeline);
+
+            engine->world()->create(transform{}, renderable{ mesh, material });
 
             engine->default_pass()->add(pipeline);
         };
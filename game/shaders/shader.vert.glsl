@@ -6,7 +6,15 @@ layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
+layout(set = 0, binding = 0) uniform frame_constants {
+    mat4 view_projection;
+} frame;
+
+layout(push_constant) uniform constants {
+    mat4 model;
+} pc;
+
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
+    gl_Position = frame.view_projection * pc.model * vec4(inPosition, 0.0, 1.0);
     fragColor = inColor;
 }
\ No newline at end of file
@@ -5,29 +5,56 @@
 #pragma once
 
 // Core
+#include <banner/core/culling.hpp>
 #include <banner/core/engine.hpp>
+#include <banner/core/frame_limiter.hpp>
+#include <banner/core/geometry.hpp>
+#include <banner/core/input.hpp>
+#include <banner/core/jobs.hpp>
 #include <banner/core/math.hpp>
+#include <banner/core/spatial_index.hpp>
+#include <banner/core/transform_graph.hpp>
 #include <banner/core/types.hpp>
 
 // Entity (ECS)
+#include <banner/entity/changes.hpp>
+#include <banner/entity/commands.hpp>
+#include <banner/entity/components.hpp>
 #include <banner/entity/entity.hpp>
+#include <banner/entity/scheduler.hpp>
+#include <banner/entity/snapshot.hpp>
 
 // Gfx
+#include <banner/gfx/buffer_pool.hpp>
+#include <banner/gfx/deletion_queue.hpp>
+#include <banner/gfx/defragmenter.hpp>
 #include <banner/gfx/device.hpp>
 #include <banner/gfx/graphics.hpp>
+#include <banner/gfx/host_allocator.hpp>
 #include <banner/gfx/memory.hpp>
 #include <banner/gfx/pipeline.hpp>
+#include <banner/gfx/render_list.hpp>
 #include <banner/gfx/render_pass.hpp>
 #include <banner/gfx/renderer.hpp>
 #include <banner/gfx/res/buffer.hpp>
+#include <banner/gfx/res/dynamic_buffer.hpp>
 #include <banner/gfx/res/mesh.hpp>
+#include <banner/gfx/res/mesh_optimizer.hpp>
+#include <banner/gfx/res/texture.hpp>
+#include <banner/gfx/sampler_cache.hpp>
 #include <banner/gfx/swapchain.hpp>
+#include <banner/gfx/texture_loader.hpp>
+#include <banner/gfx/texture_streamer.hpp>
 #include <banner/gfx/vk_utils.hpp>
 #include <banner/gfx/window.hpp>
 
 // Util
 #include <banner/util/debug.hpp>
+#include <banner/util/event.hpp>
 #include <banner/util/file.hpp>
+#include <banner/util/frame_arena.hpp>
 #include <banner/util/random.hpp>
 #include <banner/util/signal.hpp>
-#include <banner/util/time.hpp>
\ No newline at end of file
+#include <banner/util/spsc_queue.hpp>
+#include <banner/util/time.hpp>
+#include <banner/util/tlsf.hpp>
\ No newline at end of file
@@ -0,0 +1,341 @@
+#include <cmath>
+
+#include <banner/core/culling.hpp>
+#include <banner/defs.hpp>
+
+#ifdef SIMD_SSE
+#include <immintrin.h>
+#endif
+
+namespace bnr {
+namespace culling {
+namespace {
+// Appends the set bits of `mask` as indices starting at `base`. Every lane is
+// written & the cursor only advances for visible ones, so there's no branch to miss
+template<u32 Width>
+u32 compact(u32 mask, u32 base, u32* visible)
+{
+    u32 n{ 0 };
+
+    for (u32 lane = 0; lane < Width; lane++) {
+        visible[n] = base + lane;
+        n += (mask >> lane) & 1;
+    }
+
+    return n;
+}
+
+// Shapes past the table, i.e. meshes without bounds, are never culled
+const v4 no_shape[2]{ v4{ 0.f, 0.f, 0.f, 1.f }, v4{ v3{ unbounded }, 0.f } };
+
+const v4* shape(const placed_boxes& v, u32 i)
+{
+    const auto index = v.indices[i];
+    return index < v.shape_count ? v.shapes + index * 2 : no_shape;
+}
+
+/*
+    A volume is outside when it's entirely behind any plane: for a box the center
+    distance plus the extent projected on the plane normal is negative, for a sphere
+    the center distance plus the radius.
+
+    The planes are broadcast once per call, not once per batch of volumes. Placed
+    boxes are moved with Arvo's method, the center by the matrix & the extent by its
+    absolute value, & tested straight from registers.
+*/
+struct scalar
+{
+    static constexpr u32 width = 1;
+
+    explicit scalar(const frustum& view)
+        : view{ view }
+    {}
+
+    u32 test(const boxes& v, u32 i) const
+    {
+        return test(v3{ v.cx[i], v.cy[i], v.cz[i] }, v3{ v.ex[i], v.ey[i], v.ez[i] });
+    }
+
+    u32 test(const placed_boxes& v, u32 i) const
+    {
+        const auto& m = v.transforms[i];
+        const auto local = shape(v, i);
+
+        const auto c = v3{ m * local[0] };
+        const auto e = glm::abs(v3{ m[0] }) * local[1].x +
+            glm::abs(v3{ m[1] }) * local[1].y + glm::abs(v3{ m[2] }) * local[1].z;
+
+        return test(c, e);
+    }
+
+    u32 test(const spheres& v, u32 i) const
+    {
+        for (const auto& p : view.planes) {
+            const auto s =
+                p.normal.x * v.x[i] + p.normal.y * v.y[i] + p.normal.z * v.z[i] + p.d;
+
+            if (s + v.radius[i] < 0.f)
+                return 0;
+        }
+        return 1;
+    }
+
+    u32 test(const v3& center, const v3& extent) const
+    {
+        for (const auto& p : view.planes) {
+            const auto s = glm::dot(p.normal, center) + p.d;
+            const auto r = glm::dot(glm::abs(p.normal), extent);
+
+            if (s + r < 0.f)
+                return 0;
+        }
+        return 1;
+    }
+
+    const frustum& view;
+};
+
+#ifdef SIMD_SSE
+struct sse
+{
+    static constexpr u32 width = 4;
+
+    explicit sse(const frustum& view)
+    {
+        for (u32 i = 0; i < planes; i++) {
+            const auto& p = view.planes[i];
+
+            nx[i] = _mm_set1_ps(p.normal.x);
+            ny[i] = _mm_set1_ps(p.normal.y);
+            nz[i] = _mm_set1_ps(p.normal.z);
+            d[i] = _mm_set1_ps(p.d);
+            ax[i] = _mm_set1_ps(std::abs(p.normal.x));
+            ay[i] = _mm_set1_ps(std::abs(p.normal.y));
+            az[i] = _mm_set1_ps(std::abs(p.normal.z));
+        }
+    }
+
+    u32 test(const boxes& v, u32 i) const
+    {
+        return test(_mm_loadu_ps(v.cx + i), _mm_loadu_ps(v.cy + i),
+            _mm_loadu_ps(v.cz + i), _mm_loadu_ps(v.ex + i), _mm_loadu_ps(v.ey + i),
+            _mm_loadu_ps(v.ez + i));
+    }
+
+    u32 test(const placed_boxes& v, u32 i) const
+    {
+        __m128 c[4], e[4];
+        place(v, i, c, e);
+
+        return test(c[0], c[1], c[2], e[0], e[1], e[2]);
+    }
+
+    // World space centers & extents of 4 boxes, one axis per register
+    static void place(const placed_boxes& v, u32 i, __m128* c, __m128* e)
+    {
+        const auto sign = _mm_set1_ps(-0.f);
+
+        for (u32 j = 0; j < 4; j++) {
+            const auto m = reinterpret_cast<const f32*>(v.transforms + i + j);
+            const auto local = shape(v, i + j);
+
+            const auto m0 = _mm_loadu_ps(m), m1 = _mm_loadu_ps(m + 4);
+            const auto m2 = _mm_loadu_ps(m + 8), m3 = _mm_loadu_ps(m + 12);
+            const auto lc = _mm_loadu_ps(&local[0].x);
+            const auto le = _mm_loadu_ps(&local[1].x);
+
+            auto center =
+                _mm_add_ps(_mm_mul_ps(m0, splat<0>(lc)), _mm_mul_ps(m1, splat<1>(lc)));
+            center = _mm_add_ps(center, _mm_mul_ps(m2, splat<2>(lc)));
+            c[j] = _mm_add_ps(center, m3);
+
+            auto extent = _mm_add_ps(_mm_mul_ps(_mm_andnot_ps(sign, m0), splat<0>(le)),
+                _mm_mul_ps(_mm_andnot_ps(sign, m1), splat<1>(le)));
+            e[j] = _mm_add_ps(extent, _mm_mul_ps(_mm_andnot_ps(sign, m2), splat<2>(le)));
+        }
+
+        _MM_TRANSPOSE4_PS(c[0], c[1], c[2], c[3]);
+        _MM_TRANSPOSE4_PS(e[0], e[1], e[2], e[3]);
+    }
+
+    template<int lane>
+    static __m128 splat(__m128 v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(lane, lane, lane, lane));
+    }
+
+    u32 test(__m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey, __m128 ez) const
+    {
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (u32 p = 0; p < planes; p++) {
+            auto s = _mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy));
+            s = _mm_add_ps(s, _mm_mul_ps(nz[p], cz));
+            s = _mm_add_ps(s, d[p]);
+
+            auto r = _mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey));
+            r = _mm_add_ps(r, _mm_mul_ps(az[p], ez));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(s, r), _mm_setzero_ps()));
+        }
+
+        return u32(_mm_movemask_ps(inside));
+    }
+
+    u32 test(const spheres& v, u32 i) const
+    {
+        const auto x = _mm_loadu_ps(v.x + i), y = _mm_loadu_ps(v.y + i);
+        const auto z = _mm_loadu_ps(v.z + i), radius = _mm_loadu_ps(v.radius + i);
+
+        auto inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (u32 p = 0; p < planes; p++) {
+            auto s = _mm_add_ps(_mm_mul_ps(nx[p], x), _mm_mul_ps(ny[p], y));
+            s = _mm_add_ps(s, _mm_mul_ps(nz[p], z));
+            s = _mm_add_ps(s, d[p]);
+
+            const auto distance = _mm_add_ps(s, radius);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+
+        return u32(_mm_movemask_ps(inside));
+    }
+
+    static constexpr u32 planes = 6;
+
+    __m128 nx[planes], ny[planes], nz[planes], d[planes];
+    __m128 ax[planes], ay[planes], az[planes];
+};
+#endif
+
+#ifdef SIMD_AVX2
+struct avx2
+{
+    static constexpr u32 width = 8;
+
+    explicit avx2(const frustum& view)
+    {
+        for (u32 i = 0; i < planes; i++) {
+            const auto& p = view.planes[i];
+
+            nx[i] = _mm256_set1_ps(p.normal.x);
+            ny[i] = _mm256_set1_ps(p.normal.y);
+            nz[i] = _mm256_set1_ps(p.normal.z);
+            d[i] = _mm256_set1_ps(p.d);
+            ax[i] = _mm256_set1_ps(std::abs(p.normal.x));
+            ay[i] = _mm256_set1_ps(std::abs(p.normal.y));
+            az[i] = _mm256_set1_ps(std::abs(p.normal.z));
+        }
+    }
+
+    u32 test(const boxes& v, u32 i) const
+    {
+        return test(_mm256_loadu_ps(v.cx + i), _mm256_loadu_ps(v.cy + i),
+            _mm256_loadu_ps(v.cz + i), _mm256_loadu_ps(v.ex + i),
+            _mm256_loadu_ps(v.ey + i), _mm256_loadu_ps(v.ez + i));
+    }
+
+    u32 test(const placed_boxes& v, u32 i) const
+    {
+        __m128 lc[4], le[4], hc[4], he[4];
+        sse::place(v, i, lc, le);
+        sse::place(v, i + 4, hc, he);
+
+        return test(_mm256_set_m128(hc[0], lc[0]), _mm256_set_m128(hc[1], lc[1]),
+            _mm256_set_m128(hc[2], lc[2]), _mm256_set_m128(he[0], le[0]),
+            _mm256_set_m128(he[1], le[1]), _mm256_set_m128(he[2], le[2]));
+    }
+
+    u32 test(__m256 cx, __m256 cy, __m256 cz, __m256 ex, __m256 ey, __m256 ez) const
+    {
+        auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (u32 p = 0; p < planes; p++) {
+            auto s = _mm256_fmadd_ps(nx[p], cx, d[p]);
+            s = _mm256_fmadd_ps(ny[p], cy, s);
+            s = _mm256_fmadd_ps(nz[p], cz, s);
+
+            // Adds the projected extent on top of the center distance
+            s = _mm256_fmadd_ps(ax[p], ex, s);
+            s = _mm256_fmadd_ps(ay[p], ey, s);
+            s = _mm256_fmadd_ps(az[p], ez, s);
+
+            inside =
+                _mm256_and_ps(inside, _mm256_cmp_ps(s, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        return u32(_mm256_movemask_ps(inside));
+    }
+
+    u32 test(const spheres& v, u32 i) const
+    {
+        const auto x = _mm256_loadu_ps(v.x + i), y = _mm256_loadu_ps(v.y + i);
+        const auto z = _mm256_loadu_ps(v.z + i), radius = _mm256_loadu_ps(v.radius + i);
+
+        auto inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (u32 p = 0; p < planes; p++) {
+            auto s = _mm256_fmadd_ps(nx[p], x, radius);
+            s = _mm256_fmadd_ps(ny[p], y, s);
+            s = _mm256_fmadd_ps(nz[p], z, s);
+            s = _mm256_add_ps(s, d[p]);
+
+            inside =
+                _mm256_and_ps(inside, _mm256_cmp_ps(s, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        return u32(_mm256_movemask_ps(inside));
+    }
+
+    static constexpr u32 planes = 6;
+
+    __m256 nx[planes], ny[planes], nz[planes], d[planes];
+    __m256 ax[planes], ay[planes], az[planes];
+};
+
+using wide = avx2;
+#elif defined(SIMD_SSE)
+using wide = sse;
+#else
+using wide = scalar;
+#endif
+
+template<typename Volumes>
+u32 run(const frustum& view, const Volumes& volumes, u32 count, u32* visible)
+{
+    const wide batch{ view };
+    const scalar single{ view };
+
+    u32 n{ 0 };
+    u32 i{ 0 };
+
+    for (; i + wide::width <= count; i += wide::width) {
+        n += compact<wide::width>(batch.test(volumes, i), i, visible + n);
+    }
+
+    for (; i < count; i++) {
+        visible[n] = i;
+        n += single.test(volumes, i);
+    }
+
+    return n;
+}
+
+} // namespace
+
+u32 cull(const frustum& view, const boxes& volumes, u32 count, u32* visible)
+{
+    return run(view, volumes, count, visible);
+}
+
+u32 cull(const frustum& view, const spheres& volumes, u32 count, u32* visible)
+{
+    return run(view, volumes, count, visible);
+}
+
+u32 cull(const frustum& view, const placed_boxes& volumes, u32 count, u32* visible)
+{
+    return run(view, volumes, count, visible);
+}
+} // namespace culling
+} // namespace bnr
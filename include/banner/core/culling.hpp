@@ -0,0 +1,59 @@
+#pragma once
+
+#include <banner/core/geometry.hpp>
+#include <banner/core/types.hpp>
+
+namespace bnr {
+namespace culling {
+// Half extent of boxes that are never culled, finite so scaling it stays finite
+constexpr f32 unbounded = 1e30f;
+
+/**
+ * @brief World space boxes as center & half extent arrays.
+ */
+struct boxes
+{
+    const f32* cx;
+    const f32* cy;
+    const f32* cz;
+    const f32* ex;
+    const f32* ey;
+    const f32* ez;
+};
+
+/**
+ * @brief Local boxes placed by a matrix each. `shapes` holds a center (w = 1) & half
+ * extent (w = 0) pair per local box, `indices` picks one per matrix & the ones past
+ * `shape_count` are `unbounded`.
+ */
+struct placed_boxes
+{
+    const mat4* transforms;
+    const u32* indices;
+    const v4* shapes;
+    u32 shape_count;
+};
+
+struct spheres
+{
+    const f32* x;
+    const f32* y;
+    const f32* z;
+    const f32* radius;
+};
+
+/**
+ * @brief Writes the indices of the volumes that aren't fully outside `view` to
+ * `visible` in ascending order & returns how many there are. `visible` must have room
+ * for `count` indices. Tests 8 volumes per iteration with AVX2, 4 with SSE.
+ */
+u32 cull(const frustum& view, const boxes& volumes, u32 count, u32* visible);
+u32 cull(const frustum& view, const spheres& volumes, u32 count, u32* visible);
+
+/**
+ * @brief Moves the boxes to world space in registers & tests them, saves writing &
+ * reading back world space arrays.
+ */
+u32 cull(const frustum& view, const placed_boxes& volumes, u32 count, u32* visible);
+} // namespace culling
+} // namespace bnr
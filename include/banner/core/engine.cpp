@@ -1,4 +1,7 @@
+#include <thread>
+
 #include <banner/core/engine.hpp>
+#include <banner/entity/components.hpp>
 #include <banner/gfx/render_pass.hpp>
 
 namespace bnr {
@@ -43,10 +46,22 @@ engine::engine(engine::config cfg)
 {
     window_ =
         make_uptr<bnr::window>(cfg.name, cfg.window_size, cfg.icon_path, cfg.fullscreen);
-    graphics_ = make_uptr<bnr::graphics>(window_.get());
-    renderer_ = make_uptr<bnr::renderer>(graphics_.get());
+    input_ = make_uptr<bnr::input>(window_.get(), cfg.input);
+    jobs_ = make_uptr<bnr::jobs>(cfg.workers);
+    limiter_ = make_uptr<bnr::frame_limiter>(cfg.frame_limit);
+    graphics_ = make_uptr<bnr::graphics>(window_.get(), cfg.host_memory, cfg.present);
+    renderer_ = make_uptr<bnr::renderer>(graphics_.get(), jobs_.get(), cfg.latency);
+    defrag_ = make_uptr<bnr::defragmenter>(graphics_.get(), renderer_.get(), cfg.defrag);
+    textures_ =
+        make_uptr<bnr::texture_loader>(graphics_.get(), jobs_.get(), cfg.textures);
+    streamer_ = make_uptr<bnr::texture_streamer>(
+        graphics_.get(), renderer_.get(), jobs_.get(), cfg.streaming);
     default_pass_ = make_uptr<bnr::default_render_pass>(graphics_.get());
     world_ = make_uptr<bnr::world>(cfg.world_size);
+    systems_ = make_uptr<bnr::scheduler>(world_.get(), jobs_.get(), cfg.systems);
+    commands_ = make_uptr<bnr::commands>(jobs_.get());
+    spatial_ = make_uptr<bnr::spatial_index>(cfg.spatial);
+    transforms_ = make_uptr<bnr::transform_graph>();
 }
 
 engine::~engine()
@@ -60,7 +75,17 @@ void engine::run()
 {
     load();
     init();
-    update();
+
+    // The loop gets its own thread so input is stamped by the main one as it arrives
+    std::thread loop{ [this]() {
+        jobs_->attach();
+        update();
+        window_->wake();
+    } };
+
+    pump_events();
+    loop.join();
+
     if (stop_engine_) {
         teardown();
     }
@@ -68,6 +93,9 @@ void engine::run()
 
 void engine::load()
 {
+    // Relocations have to be recorded before anything reads pooled buffers
+    renderer_->add_task([&](vk::CommandBuffer buffer) { defrag_->step(buffer); });
+
     renderer_->add_task([&](vk::CommandBuffer buffer) {
         default_pass_->pass()->process(renderer_->current_index(), buffer);
     });
@@ -94,51 +122,131 @@ void engine::update()
     for (;;) {
         auto& [timer, offset] = runtime;
 
-        offset += timer.elapsed();
-        timer.restart();
+        // Holds the frame back until the gpu is about to need it
+        renderer_->pace();
 
-        if (stop_engine_ = handle_events()) {
+        if (handle_events()) {
             break;
         }
 
+        offset += timer.elapsed();
+        timer.restart();
+
+        const auto now = clock::now();
+
         while (offset >= cfg.timestep) {
             offset -= cfg.timestep;
 
+            advance_change_tick();
+
+            // Input that arrived up to the end of this step, later events wait for
+            // the step they fall in
+            input_->drain(now - offset);
+
             if (on_pre_update)
                 on_pre_update();
 
             world_->update();
+            systems_->update();
 
             if (on_update)
                 on_update();
 
             if (on_post_update)
                 on_post_update();
+
+            // Structural changes recorded during the update land here
+            commands_->apply(world_.get());
+
+            for (const auto e : commands_->destroyed()) {
+                spatial_->remove(e);
+            }
+            for (const auto e : commands_->removed<bounds>()) {
+                spatial_->remove(e);
+            }
+
+            transforms_->update();
+            spatial_->sync(world_.get(), transforms_.get(), synced_tick_);
+
+            // Touches after the sync, render stage included, land on a newer tick
+            synced_tick_ = change_tick();
+            advance_change_tick();
         }
 
         auto alpha = (f64)offset.count() / cfg.timestep.count();
+
+        // The render stage only sees what's extracted here
+        renderer_->extract(world_.get(), transforms_.get());
         render();
+
+        limiter_->wait(idle_);
     }
 }
 
 bool engine::handle_events()
 {
-    window_->handle_events();
+    const auto& limit = limiter_->opts();
+
+    idle_ = window_->is_minimized() || (limit.idle_unfocused && !window_->is_focused());
+
+    // Nothing is presented while idle, sleep until the main thread pumps an event
+    if (idle_) {
+        std::unique_lock lock{ events_mutex_ };
+
+        const auto seen = pumps_;
+        const auto woken = [&]() { return pumps_ != seen || stop_engine_; };
 
-    return window_->should_close();
+        if (const auto period = frame_limiter::period(limit.idle_fps); period > 0.0) {
+            events_pumped_.wait_for(lock, std::chrono::duration<f64>(period), woken);
+        } else {
+            events_pumped_.wait(lock, woken);
+        }
+    }
+
+    return stop_engine_;
+}
+
+void engine::pump_events()
+{
+    while (!stop_engine_) {
+        // Input callbacks fire in here & stamp their events
+        window_->wait_events(0.0);
+
+        {
+            std::lock_guard lock{ events_mutex_ };
+            stop_engine_ = stop_engine_ || window_->should_close();
+            pumps_++;
+        }
+
+        events_pumped_.notify_one();
+    }
 }
 
 void engine::render()
 {
+    textures_->update();
+    streamer_->update();
     window_->render();
+    graphics_->memory()->update();
+    graphics_->host()->end_frame();
     if (on_render)
         on_render();
 }
 
 void engine::teardown()
 {
+    /* Finish pending loads before their resources go away */
+    systems_.reset();
+    commands_.reset();
+    streamer_.reset();
+    textures_.reset();
+
+    /* Shutdown is the one place the device is drained, everything else is deferred */
+    graphics_->device()->vk().waitIdle();
+
     /* Free renderer */
     renderer_.reset();
+    defrag_.reset();
     /* Free render passes */
     default_pass_.reset();
 
@@ -149,8 +257,13 @@ void engine::teardown()
     graphics_.reset();
 
     /* Free window/input related*/
+    input_.reset();
     window_.reset();
     /* Rest ... */
+    limiter_.reset();
+    spatial_.reset();
+    transforms_.reset();
     world_.reset();
+    jobs_.reset();
 }
 } // namespace bnr
\ No newline at end of file
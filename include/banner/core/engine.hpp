@@ -1,7 +1,21 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include <banner/core/frame_limiter.hpp>
+#include <banner/core/input.hpp>
+#include <banner/core/jobs.hpp>
+#include <banner/core/spatial_index.hpp>
+#include <banner/core/transform_graph.hpp>
 #include <banner/core/types.hpp>
+#include <banner/entity/commands.hpp>
 #include <banner/entity/entity.hpp>
+#include <banner/entity/scheduler.hpp>
+#include <banner/gfx/defragmenter.hpp>
 #include <banner/gfx/graphics.hpp>
 #include <banner/gfx/renderer.hpp>
+#include <banner/gfx/texture_loader.hpp>
+#include <banner/gfx/texture_streamer.hpp>
 #include <banner/gfx/window.hpp>
 #include <banner/util/signal.hpp>
 #include <banner/util/time.hpp>
@@ -29,7 +43,19 @@ struct engine
         str icon_path = "";
         ms timestep = ms(16);
         u32 world_size = 100000;
+        // Job system worker threads, 0 uses one per hardware thread but the main one
+        u32 workers = 0;
         bool fullscreen = false;
+        defragmenter::options defrag{};
+        texture_loader::options textures{};
+        texture_streamer::options streaming{};
+        host_allocator::options host_memory{};
+        scheduler::options systems{};
+        bnr::input::options input{};
+        swapchain::policy present{ swapchain::policy::low_latency };
+        renderer::options latency{};
+        frame_limiter::options frame_limit{};
+        spatial_index::options spatial{};
     };
 
     struct runtime
@@ -42,9 +68,19 @@ struct engine
     ~engine();
 
     auto window() { return window_.get(); }
+    auto input() { return input_.get(); }
     auto renderer() { return renderer_.get(); }
     auto graphics() { return graphics_.get(); }
     auto world() { return world_.get(); }
+    auto systems() { return systems_.get(); }
+    auto commands() { return commands_.get(); }
+    auto spatial() { return spatial_.get(); }
+    auto transforms() { return transforms_.get(); }
+    auto defrag() { return defrag_.get(); }
+    auto jobs() { return jobs_.get(); }
+    auto limiter() { return limiter_.get(); }
+    auto textures() { return textures_.get(); }
+    auto streamer() { return streamer_.get(); }
     auto default_pass() { return default_pass_->pass(); }
 
     const config cfg;
@@ -56,6 +92,7 @@ struct engine
     fn<void()> on_load;
     fn<void()> on_init;
 
+    // Called on the loop thread, the main one only pumps window events meanwhile
     fn<void()> on_pre_update;
     fn<void()> on_update;
     fn<void()> on_post_update;
@@ -67,16 +104,36 @@ private:
     void load();
     void init();
     bool handle_events();
+    void pump_events();
     void update();
     void render();
     void teardown();
 
-    bool stop_engine_{ false };
+    std::atomic<bool> stop_engine_{ false };
+    // Minimized or unfocused, frames wait on window events
+    bool idle_{ false };
 
+    // Counts the main thread's event pumps, wakes the idle loop
+    std::mutex events_mutex_;
+    std::condition_variable events_pumped_;
+    u64 pumps_{ 0 };
+    // Change tick the spatial index was last synced at
+    u32 synced_tick_{ 0 };
+
+    uptr<bnr::jobs> jobs_;
+    uptr<bnr::frame_limiter> limiter_;
     uptr<bnr::window> window_;
+    uptr<bnr::input> input_;
     uptr<bnr::graphics> graphics_;
     uptr<bnr::renderer> renderer_;
+    uptr<bnr::defragmenter> defrag_;
+    uptr<bnr::texture_loader> textures_;
+    uptr<bnr::texture_streamer> streamer_;
     uptr<bnr::world> world_;
+    uptr<bnr::scheduler> systems_;
+    uptr<bnr::commands> commands_;
+    uptr<bnr::spatial_index> spatial_;
+    uptr<bnr::transform_graph> transforms_;
     uptr<bnr::default_render_pass> default_pass_;
 };
 } // namespace bnr
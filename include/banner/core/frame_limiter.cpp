@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <banner/core/frame_limiter.hpp>
+
+namespace bnr {
+namespace {
+// Weight of the newest frame in the smoothed frame time
+constexpr f64 smoothing = 0.1;
+
+// Older sleeps stop counting past this, so the slack follows the system's load
+constexpr u32 max_samples = 256;
+
+f64 micros(duration d)
+{
+    return std::chrono::duration<f64, std::micro>(d).count();
+}
+} // namespace
+
+frame_limiter::frame_limiter(options opts)
+    : opts_{ opts }
+{}
+
+void frame_limiter::wait(bool idle)
+{
+    const auto seconds = period(opts_.target_fps);
+
+    if (!idle && seconds > 0.0) {
+        const auto step = std::chrono::duration_cast<duration>(
+            std::chrono::duration<f64>(seconds));
+
+        next_ += step;
+
+        // Don't try to catch up after a long frame
+        const auto now = clock::now();
+        if (next_ < now) {
+            next_ = now;
+        }
+
+        sleep_until(next_);
+    } else {
+        next_ = clock::now();
+    }
+
+    const auto end = clock::now();
+    const auto frame = micros(end - last_);
+
+    frame_us_ = frame_us_ == 0.0 ? frame : frame_us_ + (frame - frame_us_) * smoothing;
+    last_ = end;
+}
+
+void frame_limiter::sleep_until(time_point deadline)
+{
+    auto now = clock::now();
+
+    while (micros(deadline - now) > slack_us_) {
+        const auto start = now;
+        std::this_thread::sleep_for(ms(1));
+        now = clock::now();
+
+        // Welford's running mean & variance
+        const auto observed = micros(now - start);
+        samples_ = std::min(samples_ + 1, max_samples);
+
+        const auto delta = observed - mean_us_;
+        mean_us_ += delta / samples_;
+        m2_ += delta * (observed - mean_us_);
+
+        if (samples_ == max_samples) {
+            m2_ *= f64(max_samples - 1) / max_samples;
+        }
+
+        slack_us_ = mean_us_ + std::sqrt(m2_ / std::max(samples_ - 1, 1u));
+    }
+
+    while (clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+} // namespace bnr
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <banner/core/types.hpp>
+#include <banner/util/time.hpp>
+
+namespace bnr {
+/**
+ * @brief Caps the frame rate of the engine loop. Waits sleep in 1ms steps while the
+ * remaining time is above the measured timer slack (mean + deviation of the actual
+ * sleep times) & spin for the rest, so frames end on time without burning a core.
+ */
+struct frame_limiter
+{
+    struct options
+    {
+        // 0 leaves the frame rate to the present mode
+        f32 target_fps{ 0.f };
+        // Frame rate while minimized, or unfocused with `idle_unfocused`. At 0 frames
+        // are only run when an event arrives
+        f32 idle_fps{ 10.f };
+        bool idle_unfocused{ false };
+    };
+
+    explicit frame_limiter(options opts);
+
+    /**
+     * @brief Ends the frame, waits until the next one may start unless `idle`. The
+     * engine blocks on window events while idle instead.
+     */
+    void wait(bool idle);
+
+    /**
+     * @brief Seconds per frame at `fps`, 0 when uncapped.
+     */
+    static f64 period(f32 fps) { return fps > 0.f ? 1.0 / fps : 0.0; }
+
+    auto& opts() { return opts_; }
+
+    /**
+     * @brief Smoothed time between frame ends.
+     */
+    f64 frame_us() const { return frame_us_; }
+    f64 fps() const { return frame_us_ > 0.0 ? 1e6 / frame_us_ : 0.0; }
+
+    /**
+     * @brief Sleep overshoot the spin phase covers.
+     */
+    f64 slack_us() const { return slack_us_; }
+
+private:
+    void sleep_until(time_point deadline);
+
+    options opts_;
+
+    time_point next_{ clock::now() };
+    time_point last_{ clock::now() };
+    f64 frame_us_{ 0.0 };
+
+    // Running statistics of 1ms sleeps
+    f64 mean_us_{ 1000.0 };
+    f64 m2_{ 0.0 };
+    u32 samples_{ 1 };
+    f64 slack_us_{ 2000.0 };
+};
+} // namespace bnr
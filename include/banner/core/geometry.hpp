@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <banner/core/math.hpp>
+#include <banner/core/types.hpp>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+namespace bnr {
+struct aabb
+{
+    v3 min{ std::numeric_limits<f32>::max() };
+    v3 max{ std::numeric_limits<f32>::lowest() };
+
+    v3 center() const { return (min + max) * 0.5f; }
+    v3 extent() const { return (max - min) * 0.5f; }
+
+    bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    f32 surface_area() const
+    {
+        const auto d = max - min;
+        return 2.f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    aabb expanded(f32 margin) const { return { min - v3{ margin }, max + v3{ margin } }; }
+
+    bool contains(const aabb& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.min)) &&
+            glm::all(glm::greaterThanEqual(max, other.max));
+    }
+
+    bool overlaps(const aabb& other) const
+    {
+        return glm::all(glm::lessThanEqual(min, other.max)) &&
+            glm::all(glm::greaterThanEqual(max, other.min));
+    }
+
+    static aabb merge(const aabb& a, const aabb& b)
+    {
+        return { glm::min(a.min, b.min), glm::max(a.max, b.max) };
+    }
+
+    /**
+     * @brief Bounds of this box after transforming it by `m` (affine).
+     */
+    aabb transformed(const mat4& m) const
+    {
+        const auto c = v3{ m * v4{ center(), 1.f } };
+        const auto e = extent();
+
+        const v3 r{ glm::dot(glm::abs(v3{ m[0][0], m[1][0], m[2][0] }), e),
+            glm::dot(glm::abs(v3{ m[0][1], m[1][1], m[2][1] }), e),
+            glm::dot(glm::abs(v3{ m[0][2], m[1][2], m[2][2] }), e) };
+
+        return { c - r, c + r };
+    }
+};
+
+struct sphere
+{
+    v3 center{ 0.f };
+    f32 radius{ 0.f };
+
+    bool overlaps(const aabb& box) const
+    {
+        const auto d = glm::clamp(center, box.min, box.max) - center;
+        return glm::dot(d, d) <= radius * radius;
+    }
+};
+
+struct ray
+{
+    v3 origin{ 0.f };
+    v3 direction{ 0.f, 0.f, 1.f };
+    f32 length{ std::numeric_limits<f32>::max() };
+
+    /**
+     * @brief Slab test, returns whether the box is hit within `length` and stores the
+     * entry distance in `t`.
+     */
+    bool intersects(const aabb& box, f32& t) const
+    {
+        const auto inv = 1.f / direction;
+        const auto t0 = (box.min - origin) * inv;
+        const auto t1 = (box.max - origin) * inv;
+
+        const auto lo = glm::min(t0, t1);
+        const auto hi = glm::max(t0, t1);
+
+        const auto t_min = std::max({ lo.x, lo.y, lo.z, 0.f });
+        const auto t_max = std::min({ hi.x, hi.y, hi.z, length });
+
+        t = t_min;
+        return t_min <= t_max;
+    }
+};
+
+struct plane
+{
+    v3 normal{ 0.f, 1.f, 0.f };
+    f32 d{ 0.f };
+
+    f32 distance(const v3& p) const { return glm::dot(normal, p) + d; }
+};
+
+struct frustum
+{
+    enum class test
+    {
+        outside,
+        intersects,
+        inside
+    };
+
+    // Left, right, bottom, top, near & far, normals point inwards
+    std::array<plane, 6> planes;
+
+    /**
+     * @brief Extracts the planes of a view projection matrix with a [0, 1] depth
+     * range.
+     */
+    static frustum from(const mat4& m)
+    {
+        auto row = [&](u32 i) { return v4{ m[0][i], m[1][i], m[2][i], m[3][i] }; };
+
+        const v4 rows[] = { row(3) + row(0), row(3) - row(0), row(3) + row(1),
+            row(3) - row(1), row(2), row(3) - row(2) };
+
+        frustum f;
+        for (u32 i = 0; i < 6; i++) {
+            const auto length = glm::length(v3{ rows[i] });
+            f.planes[i] = { v3{ rows[i] } / length, rows[i].w / length };
+        }
+        return f;
+    }
+
+    test classify(const aabb& box) const
+    {
+        const auto c = box.center();
+        const auto e = box.extent();
+
+        auto result = test::inside;
+
+        for (const auto& p : planes) {
+            const auto r = glm::dot(glm::abs(p.normal), e);
+            const auto s = p.distance(c);
+
+            if (s < -r)
+                return test::outside;
+
+            if (s < r) {
+                result = test::intersects;
+            }
+        }
+
+        return result;
+    }
+
+    bool overlaps(const aabb& box) const { return classify(box) != test::outside; }
+
+    bool overlaps(const sphere& s) const
+    {
+        return std::all_of(planes.begin(), planes.end(),
+            [&](const plane& p) { return p.distance(s.center) >= -s.radius; });
+    }
+};
+} // namespace bnr
@@ -0,0 +1,96 @@
+#include <banner/core/input.hpp>
+#include <banner/gfx/window.hpp>
+
+namespace bnr {
+namespace {
+// glfw actions
+constexpr i32 release = 0;
+} // namespace
+
+input::input(window* window, options opts)
+    : window_{ window }
+    , queue_{ opts.capacity }
+{
+    window_->on_key.connect<&input::key>(this);
+    window_->on_mouse_button.connect<&input::mouse_button>(this);
+    window_->on_mouse_move.connect<&input::mouse_move>(this);
+    window_->on_scroll.connect<&input::scroll>(this);
+    window_->on_char.connect<&input::character>(this);
+
+    mouse_ = window_->mouse_pos();
+}
+
+input::~input()
+{
+    window_->on_key.disconnect<&input::key>(this);
+    window_->on_mouse_button.disconnect<&input::mouse_button>(this);
+    window_->on_mouse_move.disconnect<&input::mouse_move>(this);
+    window_->on_scroll.disconnect<&input::scroll>(this);
+    window_->on_char.disconnect<&input::character>(this);
+}
+
+u32 input::drain(time_point until)
+{
+    u32 count{ 0 };
+
+    while (auto e = queue_.peek()) {
+        // Later events belong to a later step
+        if (e->time > until)
+            break;
+
+        switch (e->kind) {
+        case input_event::type::key:
+            if (e->code >= 0 && e->code < max_keys)
+                keys_[e->code] = e->action != release;
+            break;
+        case input_event::type::mouse_button:
+            if (e->code >= 0 && e->code < max_buttons)
+                buttons_[e->code] = e->action != release;
+            break;
+        case input_event::type::mouse_move:
+            mouse_ = e->value;
+            break;
+        default:
+            break;
+        }
+
+        on_event.fire(*e);
+        queue_.pop();
+        count++;
+    }
+
+    return count;
+}
+
+void input::key(i32 key, i32 scancode, i32 action, i32 mods)
+{
+    push({ input_event::type::key, clock::now(), key, action, mods });
+}
+
+void input::mouse_button(i32 button, i32 action, i32 mods)
+{
+    push({ input_event::type::mouse_button, clock::now(), button, action, mods });
+}
+
+void input::mouse_move(f64 x, f64 y)
+{
+    push({ input_event::type::mouse_move, clock::now(), 0, 0, 0, v2(x, y) });
+}
+
+void input::scroll(f64 x, f64 y)
+{
+    push({ input_event::type::scroll, clock::now(), 0, 0, 0, v2(x, y) });
+}
+
+void input::character(u32 codepoint)
+{
+    push({ input_event::type::character, clock::now(), i32(codepoint) });
+}
+
+void input::push(const input_event& e)
+{
+    if (!queue_.push(e)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+} // namespace bnr
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+
+#include <banner/core/types.hpp>
+#include <banner/util/signal.hpp>
+#include <banner/util/spsc_queue.hpp>
+#include <banner/util/time.hpp>
+
+namespace bnr {
+struct window;
+
+struct input_event
+{
+    enum class type
+    {
+        key,
+        mouse_button,
+        mouse_move,
+        scroll,
+        character
+    };
+
+    type kind;
+    time_point time;
+
+    // Key, mouse button or codepoint
+    i32 code{ 0 };
+    i32 action{ 0 };
+    i32 mods{ 0 };
+
+    // Cursor position or scroll offset
+    v2 value{ 0.f };
+};
+
+/**
+ * @brief Timestamps window input as it arrives & queues it lock free until the
+ * simulation drains it, so every event lands in the fixed step its timestamp falls in
+ * instead of the frame it was polled in. The queue has one producer, the main thread
+ * pumping window events & stamping them as they arrive, & one consumer, the engine
+ * loop on its own thread.
+ *
+ * `key_down`, `button_down` & `mouse` reflect the events drained so far.
+ */
+struct input
+{
+    struct options
+    {
+        u32 capacity{ 1024 };
+    };
+
+    input(window* window, options opts);
+    ~input();
+
+    input(const input&) = delete;
+    input& operator=(const input&) = delete;
+
+    /**
+     * @brief Applies & fires `on_event` for the queued events up to `until`, returns
+     * how many there were.
+     */
+    u32 drain(time_point until);
+
+    bool key_down(i32 key) const { return key >= 0 && key < max_keys && keys_[key]; }
+    bool button_down(i32 button) const
+    {
+        return button >= 0 && button < max_buttons && buttons_[button];
+    }
+    v2 mouse() const { return mouse_; }
+
+    /**
+     * @brief Events lost to a full queue.
+     */
+    u32 dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    signal<void(const input_event&)> on_event;
+
+private:
+    static constexpr i32 max_keys = 512;
+    static constexpr i32 max_buttons = 8;
+
+    void key(i32 key, i32 scancode, i32 action, i32 mods);
+    void mouse_button(i32 button, i32 action, i32 mods);
+    void mouse_move(f64 x, f64 y);
+    void scroll(f64 x, f64 y);
+    void character(u32 codepoint);
+
+    void push(const input_event& e);
+
+    window* window_;
+    spsc_queue<input_event> queue_;
+    std::atomic<u32> dropped_{ 0 };
+
+    std::bitset<max_keys> keys_;
+    std::bitset<max_buttons> buttons_;
+    v2 mouse_{ 0.f };
+};
+} // namespace bnr
@@ -0,0 +1,183 @@
+#include <banner/core/jobs.hpp>
+
+namespace bnr {
+namespace {
+thread_local u32 current_index = ~0u;
+} // namespace
+
+jobs::jobs(u32 workers)
+{
+    if (workers == 0) {
+        workers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    current_index = 0;
+
+    for (u32 i = 0; i <= workers; i++) {
+        queues_.push_back(make_uptr<queue>());
+    }
+
+    for (u32 i = 1; i <= workers; i++) {
+        threads_.emplace_back([this, i]() { work(i); });
+    }
+}
+
+jobs::~jobs()
+{
+    {
+        std::lock_guard lock{ sleep_mutex_ };
+        stop_ = true;
+    }
+
+    wake_.notify_all();
+
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void jobs::run(fn<void()> task, counter* signal, counter* dependency)
+{
+    if (signal) {
+        signal->value_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    job j{ std::move(task), signal };
+
+    if (dependency) {
+        std::lock_guard lock{ dependency->mutex_ };
+
+        if (!dependency->done()) {
+            dependency->continuations_.push_back(std::move(j));
+            return;
+        }
+    }
+
+    push(std::move(j));
+}
+
+void jobs::wait(counter& counter)
+{
+    while (!counter.done()) {
+        job j;
+
+        if (pop(j)) {
+            execute(j);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last job may still be releasing its continuations
+    std::lock_guard sync{ counter.mutex_ };
+}
+
+u32 jobs::thread_index()
+{
+    return current_index;
+}
+
+void jobs::attach()
+{
+    current_index = 0;
+}
+
+void jobs::push(job&& j)
+{
+    const auto index = current_index < queues_.size() ? current_index : 0;
+
+    {
+        auto& q = *queues_[index];
+        std::lock_guard lock{ q.mutex };
+        q.jobs.push_back(std::move(j));
+    }
+
+    pending_.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard lock{ sleep_mutex_ };
+    }
+
+    wake_.notify_one();
+}
+
+bool jobs::pop(job& j)
+{
+    if (pending_.load(std::memory_order_acquire) == 0)
+        return false;
+
+    const auto count = u32(queues_.size());
+    const auto index = current_index < count ? current_index : 0;
+
+    // Newest job of our own queue first, it's the most likely to be in cache
+    {
+        auto& q = *queues_[index];
+        std::lock_guard lock{ q.mutex };
+
+        if (!q.jobs.empty()) {
+            j = std::move(q.jobs.back());
+            q.jobs.pop_back();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another queue
+    for (u32 i = 1; i < count; i++) {
+        auto& q = *queues_[(index + i) % count];
+        std::lock_guard lock{ q.mutex };
+
+        if (!q.jobs.empty()) {
+            j = std::move(q.jobs.front());
+            q.jobs.pop_front();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void jobs::execute(job& j)
+{
+    j.task();
+
+    if (!j.signal)
+        return;
+
+    vector<job> ready;
+
+    {
+        std::lock_guard lock{ j.signal->mutex_ };
+
+        if (j.signal->value_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(j.signal->continuations_);
+        }
+    }
+
+    for (auto& next : ready) {
+        push(std::move(next));
+    }
+}
+
+void jobs::work(u32 index)
+{
+    current_index = index;
+
+    for (;;) {
+        job j;
+
+        if (pop(j)) {
+            execute(j);
+            continue;
+        }
+
+        std::unique_lock lock{ sleep_mutex_ };
+
+        if (stop_ && pending_ == 0)
+            return;
+
+        wake_.wait(lock, [this]() { return stop_ || pending_ > 0; });
+    }
+}
+} // namespace bnr
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief Work stealing job system. Every worker and the thread that created the
+ * system own a deque, jobs are pushed to & popped from the back of the owner's deque
+ * and stolen from the front of the others. Waiting on a counter runs queued jobs
+ * instead of blocking.
+ */
+struct jobs
+{
+    struct counter;
+
+private:
+    struct job
+    {
+        fn<void()> task;
+        counter* signal;
+    };
+
+public:
+    /**
+     * @brief Amount of unfinished jobs, jobs can be held back until a counter reaches
+     * zero. Counters shouldn't be reused before they've been waited on.
+     */
+    struct counter
+    {
+        counter() = default;
+        counter(const counter&) = delete;
+        counter& operator=(const counter&) = delete;
+
+        bool done() const { return value_.load(std::memory_order_acquire) == 0; }
+        u32 value() const { return value_.load(std::memory_order_acquire); }
+
+    private:
+        friend struct jobs;
+
+        std::atomic<u32> value_{ 0 };
+        std::mutex mutex_;
+        vector<job> continuations_;
+    };
+
+    /**
+     * @brief Spawns `workers` threads, 0 uses one per hardware thread except the
+     * calling one.
+     */
+    explicit jobs(u32 workers);
+    ~jobs();
+
+    jobs(const jobs&) = delete;
+    jobs& operator=(const jobs&) = delete;
+
+    /**
+     * @brief Queues `task`, `signal` counts it until it has finished. With a
+     * `dependency` the task is held back until that counter reaches zero.
+     */
+    void run(fn<void()> task, counter* signal = nullptr, counter* dependency = nullptr);
+
+    /**
+     * @brief Runs queued jobs until `counter` reaches zero.
+     */
+    void wait(counter& counter);
+
+    /**
+     * @brief Calls `f(begin, end)` over [0, count) in ranges of at least `grain`,
+     * the calling thread takes part and returns once every range is done.
+     */
+    template<typename F>
+    void parallel_for(u32 count, u32 grain, F&& f)
+    {
+        if (count == 0)
+            return;
+
+        const auto max_ranges = (workers() + 1) * 4;
+        const auto size = std::max({ grain, 1u, (count + max_ranges - 1) / max_ranges });
+
+        counter done;
+
+        for (auto begin = size; begin < count; begin += size) {
+            run([&f, begin, end = std::min(begin + size, count)]() { f(begin, end); },
+                &done);
+        }
+
+        f(0u, std::min(size, count));
+        wait(done);
+    }
+
+    auto workers() const { return u32(threads_.size()); }
+
+    /**
+     * @brief 0 for the creating thread, 1.. for workers, `~0u` for other threads.
+     */
+    static u32 thread_index();
+
+    /**
+     * @brief Hands the creating thread's queue to the calling thread, the creating
+     * one mustn't use the system until the caller stopped using it.
+     */
+    void attach();
+
+private:
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<job> jobs;
+    };
+
+    void push(job&& j);
+    bool pop(job& j);
+    void execute(job& j);
+    void work(u32 index);
+
+    vector<uptr<queue>> queues_;
+    vector<std::thread> threads_;
+
+    std::atomic<u32> pending_{ 0 };
+    std::atomic<bool> stop_{ false };
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+};
+} // namespace bnr
@@ -0,0 +1,313 @@
+#include <cstring>
+#include <type_traits>
+
+#include <banner/core/spatial_index.hpp>
+#include <banner/defs.hpp>
+#include <banner/entity/components.hpp>
+
+namespace bnr {
+namespace {
+// realm doesn't hash entities, they're small & trivially copyable though
+u64 key(entity e)
+{
+    static_assert(sizeof(entity) <= sizeof(u64) && std::is_trivially_copyable_v<entity>);
+
+    u64 bits{ 0 };
+    std::memcpy(&bits, &e, sizeof(e));
+    return bits;
+}
+} // namespace
+
+spatial_index::spatial_index(options opts)
+    : opts_{ opts }
+{}
+
+spatial_index::proxy spatial_index::insert(entity e, const aabb& bounds)
+{
+    const auto id = allocate();
+
+    nodes_[id].box = bounds.expanded(opts_.margin);
+    nodes_[id].key = e;
+    nodes_[id].height = 0;
+
+    insert_leaf(id);
+    leaves_++;
+    proxies_[key(e)] = id;
+
+    return id;
+}
+
+void spatial_index::remove(proxy id)
+{
+    ASSERT(id < nodes_.size() && nodes_[id].leaf(), "Invalid spatial proxy");
+
+    const auto& n = nodes_[id];
+
+    const auto it = proxies_.find(key(n.key));
+    if (it != proxies_.end() && it->second == id) {
+        proxies_.erase(it);
+    }
+
+    if (n.follows != transform_graph::invalid) {
+        followers_[n.follows].id = invalid;
+    }
+
+    remove_leaf(id);
+    release(id);
+    leaves_--;
+}
+
+void spatial_index::remove(entity e)
+{
+    if (const auto it = proxies_.find(key(e)); it != proxies_.end()) {
+        remove(it->second);
+    }
+}
+
+void spatial_index::follow(proxy id, const transform_graph* graph,
+    transform_graph::handle node, const aabb& local)
+{
+    if (node >= followers_.size()) {
+        followers_.resize(node + 1);
+    }
+
+    auto& f = followers_[node];
+    if (f.id != invalid) {
+        nodes_[f.id].follows = transform_graph::invalid;
+    }
+
+    auto& follows = nodes_[id].follows;
+    if (follows != transform_graph::invalid) {
+        followers_[follows].id = invalid;
+    }
+
+    f = { id, local };
+    follows = node;
+
+    move(id, local.transformed(graph->world(node)));
+}
+
+bool spatial_index::move(proxy id, const aabb& bounds)
+{
+    if (nodes_[id].box.contains(bounds))
+        return false;
+
+    remove_leaf(id);
+    nodes_[id].box = bounds.expanded(opts_.margin);
+    insert_leaf(id);
+
+    return true;
+}
+
+void spatial_index::sync(world* world, const transform_graph* graph, u32 since)
+{
+    bnr::query(world, since, [&](changed<transform> t, const bounds& b) {
+        if (b.proxy != invalid) {
+            move(b.proxy, b.local.transformed(t->matrix()));
+        }
+    });
+
+    if (!graph)
+        return;
+
+    graph->each_updated([&](transform_graph::handle node) {
+        if (node < followers_.size() && followers_[node].id != invalid) {
+            const auto& f = followers_[node];
+            move(f.id, f.local.transformed(graph->world(node)));
+        }
+    });
+}
+
+spatial_index::proxy spatial_index::allocate()
+{
+    if (free_ == invalid) {
+        nodes_.emplace_back();
+        return proxy(nodes_.size() - 1);
+    }
+
+    // Free nodes are chained through their parent
+    const auto id = free_;
+    free_ = nodes_[id].parent;
+    nodes_[id] = {};
+
+    return id;
+}
+
+void spatial_index::release(proxy id)
+{
+    nodes_[id] = {};
+    nodes_[id].parent = free_;
+    free_ = id;
+}
+
+void spatial_index::insert_leaf(proxy leaf)
+{
+    if (root_ == invalid) {
+        root_ = leaf;
+        nodes_[leaf].parent = invalid;
+        return;
+    }
+
+    // Walk down to the sibling that grows the tree's surface area the least
+    const auto box = nodes_[leaf].box;
+    auto index = root_;
+
+    while (!nodes_[index].leaf()) {
+        const auto& n = nodes_[index];
+
+        const auto area = n.box.surface_area();
+        const auto combined = aabb::merge(n.box, box).surface_area();
+
+        // Pairing with this node creates a parent, descending grows the node itself
+        const auto cost = 2.f * combined;
+        const auto inheritance = 2.f * (combined - area);
+
+        auto descend = [&](proxy child) {
+            const auto& c = nodes_[child];
+            const auto merged = aabb::merge(box, c.box).surface_area();
+
+            return (c.leaf() ? merged : merged - c.box.surface_area()) + inheritance;
+        };
+
+        const auto left = descend(n.left);
+        const auto right = descend(n.right);
+
+        if (cost < left && cost < right)
+            break;
+
+        index = left < right ? n.left : n.right;
+    }
+
+    const auto sibling = index;
+    const auto old_parent = nodes_[sibling].parent;
+    const auto parent = allocate();
+
+    auto& p = nodes_[parent];
+    p.parent = old_parent;
+    p.box = aabb::merge(box, nodes_[sibling].box);
+    p.height = nodes_[sibling].height + 1;
+    p.left = sibling;
+    p.right = leaf;
+
+    if (old_parent != invalid) {
+        replace_child(old_parent, sibling, parent);
+    } else {
+        root_ = parent;
+    }
+
+    nodes_[sibling].parent = parent;
+    nodes_[leaf].parent = parent;
+
+    refit(parent);
+}
+
+void spatial_index::remove_leaf(proxy leaf)
+{
+    if (leaf == root_) {
+        root_ = invalid;
+        return;
+    }
+
+    const auto parent = nodes_[leaf].parent;
+    const auto grand_parent = nodes_[parent].parent;
+    const auto sibling =
+        nodes_[parent].left == leaf ? nodes_[parent].right : nodes_[parent].left;
+
+    release(parent);
+    nodes_[leaf].parent = invalid;
+
+    if (grand_parent == invalid) {
+        root_ = sibling;
+        nodes_[sibling].parent = invalid;
+        return;
+    }
+
+    // The sibling takes the parent's place
+    replace_child(grand_parent, parent, sibling);
+    nodes_[sibling].parent = grand_parent;
+
+    refit(grand_parent);
+}
+
+void spatial_index::refit(proxy id)
+{
+    while (id != invalid) {
+        id = balance(id);
+
+        auto& n = nodes_[id];
+        const auto& l = nodes_[n.left];
+        const auto& r = nodes_[n.right];
+
+        n.height = 1 + std::max(l.height, r.height);
+        n.box = aabb::merge(l.box, r.box);
+
+        id = n.parent;
+    }
+}
+
+spatial_index::proxy spatial_index::balance(proxy a_id)
+{
+    auto& a = nodes_[a_id];
+
+    if (a.leaf() || a.height < 2)
+        return a_id;
+
+    const auto b_id = a.left;
+    const auto c_id = a.right;
+    auto& b = nodes_[b_id];
+    auto& c = nodes_[c_id];
+
+    const auto skew = c.height - b.height;
+
+    // Rotate the taller child up, its taller child stays below it
+    auto rotate = [&](proxy up_id, node& up, node& other, bool right) {
+        const auto f_id = up.left;
+        const auto g_id = up.right;
+        auto& f = nodes_[f_id];
+        auto& g = nodes_[g_id];
+
+        up.left = a_id;
+        up.parent = a.parent;
+        a.parent = up_id;
+
+        if (up.parent != invalid) {
+            replace_child(up.parent, a_id, up_id);
+        } else {
+            root_ = up_id;
+        }
+
+        const auto keep_id = f.height > g.height ? f_id : g_id;
+        const auto move_id = f.height > g.height ? g_id : f_id;
+        auto& keep = nodes_[keep_id];
+        auto& moved = nodes_[move_id];
+
+        up.right = keep_id;
+        (right ? a.right : a.left) = move_id;
+        moved.parent = a_id;
+
+        a.box = aabb::merge(other.box, moved.box);
+        up.box = aabb::merge(a.box, keep.box);
+
+        a.height = 1 + std::max(other.height, moved.height);
+        up.height = 1 + std::max(a.height, keep.height);
+    };
+
+    if (skew > 1) {
+        rotate(c_id, c, b, true);
+        return c_id;
+    }
+
+    if (skew < -1) {
+        rotate(b_id, b, c, false);
+        return b_id;
+    }
+
+    return a_id;
+}
+
+void spatial_index::replace_child(proxy parent, proxy from, proxy to)
+{
+    auto& p = nodes_[parent];
+    (p.left == from ? p.left : p.right) = to;
+}
+} // namespace bnr
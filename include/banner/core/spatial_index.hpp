@@ -0,0 +1,223 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <banner/core/geometry.hpp>
+#include <banner/core/transform_graph.hpp>
+#include <banner/core/types.hpp>
+#include <banner/entity/entity.hpp>
+
+namespace bnr {
+/**
+ * @brief Dynamic aabb tree over entities. Leaves hold fattened bounds so small moves
+ * don't touch the tree, inserts pick the sibling with the lowest surface area cost
+ * and the tree is kept balanced with rotations.
+ * https://box2d.org/files/ErinCatto_DynamicBVH_GDC2019.pdf
+ */
+struct spatial_index
+{
+    using proxy = u32;
+
+    static constexpr proxy invalid = ~0u;
+
+    struct options
+    {
+        // Bounds are grown by this much so objects can move a bit without a reinsert
+        f32 margin{ 0.1f };
+    };
+
+    explicit spatial_index(options opts);
+
+    proxy insert(entity e, const aabb& bounds);
+    void remove(proxy id);
+
+    /**
+     * @brief Removes the proxy `e` was last inserted with, if it still has one.
+     */
+    void remove(entity e);
+
+    /**
+     * @brief Moves the proxy along with `node` from now on, `local` being its bounds in
+     * the node's space. Lasts until the proxy is removed or another one follows `node`.
+     */
+    void follow(proxy id, const transform_graph* graph, transform_graph::handle node,
+        const aabb& local);
+
+    /**
+     * @brief Returns whether the proxy had to be reinserted.
+     */
+    bool move(proxy id, const aabb& bounds);
+
+    /**
+     * @brief Moves the entities with a registered `bounds` whose `transform` changed
+     * after tick `since` & the proxies following nodes that the last update of `graph`
+     * recomputed. Only entities that left their fat bounds touch the tree, finding the
+     * changed transforms is a pass over every entity with `transform` & `bounds`.
+     */
+    void sync(world* world, const transform_graph* graph, u32 since);
+
+    entity get(proxy id) const { return nodes_[id].key; }
+    const aabb& fat_bounds(proxy id) const { return nodes_[id].box; }
+
+    u32 size() const { return leaves_; }
+    u32 height() const { return root_ == invalid ? 0 : u32(nodes_[root_].height); }
+
+    /**
+     * @brief Calls `f(entity)` for every entity whose fat bounds overlap the volume.
+     */
+    template<typename F>
+    void query(const aabb& box, F&& f) const
+    {
+        if (root_ != invalid) {
+            traverse(root_, [&](const aabb& b) { return box.overlaps(b); }, f);
+        }
+    }
+
+    template<typename F>
+    void query(const sphere& s, F&& f) const
+    {
+        if (root_ != invalid) {
+            traverse(root_, [&](const aabb& b) { return s.overlaps(b); }, f);
+        }
+    }
+
+    template<typename F>
+    void query(const frustum& fr, F&& f) const
+    {
+        if (root_ != invalid) {
+            cull(root_, fr, f);
+        }
+    }
+
+    /**
+     * @brief Calls `f(entity, t)` for the entities whose fat bounds are hit, `t` being
+     * the entry distance. `f` returns the new ray length, so a nearest hit search can
+     * clip the ray & 0 stops the cast.
+     */
+    template<typename F>
+    void raycast(const ray& r, F&& f) const
+    {
+        if (root_ != invalid) {
+            auto clipped = r;
+            cast(root_, clipped, f);
+        }
+    }
+
+private:
+    struct node
+    {
+        aabb box;
+        entity key{};
+        transform_graph::handle follows{ transform_graph::invalid };
+
+        proxy parent{ invalid };
+        proxy left{ invalid };
+        proxy right{ invalid };
+
+        // Leaves are 0, free nodes -1
+        i32 height{ -1 };
+
+        bool leaf() const { return left == invalid; }
+    };
+
+    template<typename Overlaps, typename F>
+    void traverse(proxy id, const Overlaps& overlaps, F& f) const
+    {
+        const auto& n = nodes_[id];
+
+        if (!overlaps(n.box))
+            return;
+
+        if (n.leaf()) {
+            f(n.key);
+            return;
+        }
+
+        traverse(n.left, overlaps, f);
+        traverse(n.right, overlaps, f);
+    }
+
+    template<typename F>
+    void cull(proxy id, const frustum& fr, F& f) const
+    {
+        const auto& n = nodes_[id];
+
+        switch (fr.classify(n.box)) {
+        case frustum::test::outside:
+            return;
+        case frustum::test::inside:
+            // Everything below is visible, skip the plane tests
+            report(id, f);
+            return;
+        default:
+            break;
+        }
+
+        if (n.leaf()) {
+            f(n.key);
+            return;
+        }
+
+        cull(n.left, fr, f);
+        cull(n.right, fr, f);
+    }
+
+    template<typename F>
+    void report(proxy id, F& f) const
+    {
+        const auto& n = nodes_[id];
+
+        if (n.leaf()) {
+            f(n.key);
+            return;
+        }
+
+        report(n.left, f);
+        report(n.right, f);
+    }
+
+    template<typename F>
+    bool cast(proxy id, ray& r, F& f) const
+    {
+        const auto& n = nodes_[id];
+
+        f32 t;
+        if (!r.intersects(n.box, t))
+            return true;
+
+        if (n.leaf()) {
+            r.length = std::min(r.length, f32(f(n.key, t)));
+            return r.length > 0.f;
+        }
+
+        return cast(n.left, r, f) && cast(n.right, r, f);
+    }
+
+    proxy allocate();
+    void release(proxy id);
+
+    void insert_leaf(proxy leaf);
+    void remove_leaf(proxy leaf);
+    void refit(proxy id);
+    proxy balance(proxy id);
+    void replace_child(proxy parent, proxy from, proxy to);
+
+    struct follower
+    {
+        proxy id{ invalid };
+        aabb local;
+    };
+
+    options opts_;
+
+    vector<node> nodes_;
+    proxy root_{ invalid };
+    proxy free_{ invalid };
+    u32 leaves_{ 0 };
+
+    // Leaves by entity bits, so removed & destroyed entities find their proxy
+    std::unordered_map<u64, proxy> proxies_;
+    // Per transform graph handle
+    vector<follower> followers_;
+};
+} // namespace bnr
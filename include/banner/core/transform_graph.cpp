@@ -0,0 +1,517 @@
+#include <algorithm>
+
+#include <banner/core/transform_graph.hpp>
+#include <banner/defs.hpp>
+
+#ifdef SIMD_SSE
+#include <immintrin.h>
+#endif
+
+namespace bnr {
+namespace {
+/*
+    Every instruction set composes `width` local matrices at once, `c[col][row]`
+    holds that matrix element for each of them.
+*/
+struct scalar
+{
+    using reg = f32;
+    static constexpr u32 width = 1;
+
+    static reg load(const f32* p) { return *p; }
+    static reg set1(f32 v) { return v; }
+    static reg add(reg a, reg b) { return a + b; }
+    static reg sub(reg a, reg b) { return a - b; }
+    static reg mul(reg a, reg b) { return a * b; }
+
+    static void store(f32* out, const reg (&c)[4][4])
+    {
+        for (u32 col = 0; col < 4; col++) {
+            for (u32 row = 0; row < 4; row++) {
+                out[col * 4 + row] = c[col][row];
+            }
+        }
+    }
+};
+
+#ifdef SIMD_SSE
+struct sse
+{
+    using reg = __m128;
+    static constexpr u32 width = 4;
+
+    static reg load(const f32* p) { return _mm_loadu_ps(p); }
+    static reg set1(f32 v) { return _mm_set1_ps(v); }
+    static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+
+    static void store(f32* out, const reg (&c)[4][4])
+    {
+        for (u32 col = 0; col < 4; col++) {
+            auto r0 = c[col][0], r1 = c[col][1], r2 = c[col][2], r3 = c[col][3];
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+            _mm_storeu_ps(out + 0 * 16 + col * 4, r0);
+            _mm_storeu_ps(out + 1 * 16 + col * 4, r1);
+            _mm_storeu_ps(out + 2 * 16 + col * 4, r2);
+            _mm_storeu_ps(out + 3 * 16 + col * 4, r3);
+        }
+    }
+};
+#endif
+
+#ifdef SIMD_AVX2
+struct avx2
+{
+    using reg = __m256;
+    static constexpr u32 width = 8;
+
+    static reg load(const f32* p) { return _mm256_loadu_ps(p); }
+    static reg set1(f32 v) { return _mm256_set1_ps(v); }
+    static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+    static reg sub(reg a, reg b) { return _mm256_sub_ps(a, b); }
+    static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+
+    static void store(f32* out, const reg (&c)[4][4])
+    {
+        // Transposed as two sets of four
+        sse::reg lo[4][4], hi[4][4];
+
+        for (u32 col = 0; col < 4; col++) {
+            for (u32 row = 0; row < 4; row++) {
+                lo[col][row] = _mm256_castps256_ps128(c[col][row]);
+                hi[col][row] = _mm256_extractf128_ps(c[col][row], 1);
+            }
+        }
+
+        sse::store(out, lo);
+        sse::store(out + 4 * 16, hi);
+    }
+};
+
+using wide = avx2;
+#elif defined(SIMD_SSE)
+using wide = sse;
+#else
+using wide = scalar;
+#endif
+
+template<typename isa, typename Locals>
+void compose_batch(const Locals& l, u32 i, f32* out)
+{
+    using reg = typename isa::reg;
+
+    const auto one = isa::set1(1.f);
+    const auto two = isa::set1(2.f);
+
+    const auto x = isa::load(&l.rx[i]), y = isa::load(&l.ry[i]);
+    const auto z = isa::load(&l.rz[i]), w = isa::load(&l.rw[i]);
+    const auto sx = isa::load(&l.sx[i]), sy = isa::load(&l.sy[i]);
+    const auto sz = isa::load(&l.sz[i]);
+
+    const auto xx = isa::mul(x, x), yy = isa::mul(y, y), zz = isa::mul(z, z);
+    const auto xy = isa::mul(x, y), xz = isa::mul(x, z), yz = isa::mul(y, z);
+    const auto wx = isa::mul(w, x), wy = isa::mul(w, y), wz = isa::mul(w, z);
+
+    auto twice = [&](reg a) { return isa::mul(two, a); };
+    auto diagonal = [&](reg a, reg b) { return isa::sub(one, twice(isa::add(a, b))); };
+
+    // Rotation scaled per column, translation last
+    const reg c[4][4] = {
+        { isa::mul(diagonal(yy, zz), sx), isa::mul(twice(isa::add(xy, wz)), sx),
+            isa::mul(twice(isa::sub(xz, wy)), sx), isa::set1(0.f) },
+        { isa::mul(twice(isa::sub(xy, wz)), sy), isa::mul(diagonal(xx, zz), sy),
+            isa::mul(twice(isa::add(yz, wx)), sy), isa::set1(0.f) },
+        { isa::mul(twice(isa::add(xz, wy)), sz), isa::mul(twice(isa::sub(yz, wx)), sz),
+            isa::mul(diagonal(xx, yy), sz), isa::set1(0.f) },
+        { isa::load(&l.px[i]), isa::load(&l.py[i]), isa::load(&l.pz[i]), one },
+    };
+
+    isa::store(out, c);
+}
+
+// out = a * b, `out` may alias either
+void multiply(const f32* a, const f32* b, f32* out)
+{
+#ifdef SIMD_SSE
+    const auto a0 = _mm_loadu_ps(a + 0), a1 = _mm_loadu_ps(a + 4);
+    const auto a2 = _mm_loadu_ps(a + 8), a3 = _mm_loadu_ps(a + 12);
+
+    __m128 r[4];
+    for (u32 col = 0; col < 4; col++) {
+        const auto* c = b + col * 4;
+        const auto x = _mm_add_ps(
+            _mm_mul_ps(a0, _mm_set1_ps(c[0])), _mm_mul_ps(a1, _mm_set1_ps(c[1])));
+        const auto y = _mm_add_ps(
+            _mm_mul_ps(a2, _mm_set1_ps(c[2])), _mm_mul_ps(a3, _mm_set1_ps(c[3])));
+
+        r[col] = _mm_add_ps(x, y);
+    }
+
+    for (u32 col = 0; col < 4; col++) {
+        _mm_storeu_ps(out + col * 4, r[col]);
+    }
+#else
+    f32 r[16];
+    for (u32 col = 0; col < 4; col++) {
+        for (u32 row = 0; row < 4; row++) {
+            r[col * 4 + row] = a[row] * b[col * 4] + a[4 + row] * b[col * 4 + 1] +
+                a[8 + row] * b[col * 4 + 2] + a[12 + row] * b[col * 4 + 3];
+        }
+    }
+    std::copy(r, r + 16, out);
+#endif
+}
+} // namespace
+
+void transform_graph::locals::push()
+{
+    // Identity: no translation, unit quaternion & unit scale
+    for (auto* v : { &px, &py, &pz, &rx, &ry, &rz }) {
+        v->push_back(0.f);
+    }
+
+    for (auto* v : { &rw, &sx, &sy, &sz }) {
+        v->push_back(1.f);
+    }
+}
+
+void transform_graph::locals::resize(u32 count)
+{
+    for (auto* v : all()) {
+        v->resize(count);
+    }
+}
+
+void transform_graph::locals::copy(u32 dst, const locals& src, u32 src_slot)
+{
+    const auto to = all();
+    const auto from = src.all();
+
+    for (u32 i = 0; i < to.size(); i++) {
+        (*to[i])[dst] = (*from[i])[src_slot];
+    }
+}
+
+transform_graph::handle transform_graph::create(handle parent)
+{
+    handle id;
+
+    if (!free_.empty()) {
+        id = free_.back();
+        free_.pop_back();
+    } else {
+        id = handle(links_.size());
+        links_.emplace_back();
+    }
+
+    const auto slot = u32(handles_.size());
+
+    links_[id] = {};
+    links_[id].alive = true;
+    links_[id].slot = slot;
+
+    locals_.push();
+    world_.emplace_back(1.f);
+    parents_.push_back(invalid);
+    sizes_.push_back(1);
+    handles_.push_back(id);
+
+    attach(id, parent);
+
+    // Appending to the last subtree keeps the order intact, anything else is re-sorted
+    if (parent != invalid && sorted_) {
+        const auto parent_slot = links_[parent].slot;
+
+        if (parent_slot + sizes_[parent_slot] == slot) {
+            parents_[slot] = parent_slot;
+
+            for (auto a = parent; a != invalid; a = links_[a].parent) {
+                sizes_[links_[a].slot]++;
+            }
+        } else {
+            sorted_ = false;
+        }
+    }
+
+    mark(id);
+    alive_++;
+
+    return id;
+}
+
+void transform_graph::destroy(handle id)
+{
+    detach(id);
+
+    // Free the whole subtree
+    vector<handle> stack{ id };
+
+    while (!stack.empty()) {
+        const auto h = stack.back();
+        stack.pop_back();
+
+        for (auto c = links_[h].first_child; c != invalid; c = links_[c].next_sibling) {
+            stack.push_back(c);
+        }
+
+        links_[h].alive = false;
+        free_.push_back(h);
+        alive_--;
+    }
+
+    sorted_ = false;
+}
+
+void transform_graph::set_parent(handle id, handle parent)
+{
+    for (auto a = parent; a != invalid; a = links_[a].parent) {
+        ASSERT(a != id, "A node can't be parented to its own subtree");
+    }
+
+    detach(id);
+    attach(id, parent);
+
+    sorted_ = false;
+    mark(id);
+}
+
+void transform_graph::set_position(handle id, const v3& position)
+{
+    const auto slot = links_[id].slot;
+
+    locals_.px[slot] = position.x;
+    locals_.py[slot] = position.y;
+    locals_.pz[slot] = position.z;
+
+    mark(id);
+}
+
+void transform_graph::set_rotation(handle id, const quat& rotation)
+{
+    const auto slot = links_[id].slot;
+
+    locals_.rx[slot] = rotation.x;
+    locals_.ry[slot] = rotation.y;
+    locals_.rz[slot] = rotation.z;
+    locals_.rw[slot] = rotation.w;
+
+    mark(id);
+}
+
+void transform_graph::set_scale(handle id, const v3& scale)
+{
+    const auto slot = links_[id].slot;
+
+    locals_.sx[slot] = scale.x;
+    locals_.sy[slot] = scale.y;
+    locals_.sz[slot] = scale.z;
+
+    mark(id);
+}
+
+v3 transform_graph::position(handle id) const
+{
+    const auto slot = links_[id].slot;
+    return { locals_.px[slot], locals_.py[slot], locals_.pz[slot] };
+}
+
+quat transform_graph::rotation(handle id) const
+{
+    const auto slot = links_[id].slot;
+    return { locals_.rw[slot], locals_.rx[slot], locals_.ry[slot], locals_.rz[slot] };
+}
+
+v3 transform_graph::scale(handle id) const
+{
+    const auto slot = links_[id].slot;
+    return { locals_.sx[slot], locals_.sy[slot], locals_.sz[slot] };
+}
+
+void transform_graph::update()
+{
+    updated_ = 0;
+    updated_ranges_.clear();
+
+    if (!sorted_) {
+        sort();
+        compose(0, u32(handles_.size()));
+
+        for (auto h : dirty_) {
+            links_[h].dirty = false;
+        }
+        dirty_.clear();
+        return;
+    }
+
+    if (dirty_.empty())
+        return;
+
+    dirty_slots_.clear();
+
+    for (auto h : dirty_) {
+        if (links_[h].alive) {
+            dirty_slots_.push_back(links_[h].slot);
+        }
+        links_[h].dirty = false;
+    }
+
+    dirty_.clear();
+    std::sort(dirty_slots_.begin(), dirty_slots_.end());
+
+    // Subtrees are contiguous, nested ones are skipped & neighbours merged
+    u32 begin{ 0 }, end{ 0 };
+
+    for (auto slot : dirty_slots_) {
+        if (slot < end)
+            continue;
+
+        if (slot > end) {
+            compose(begin, end);
+            begin = slot;
+        }
+
+        end = slot + sizes_[slot];
+    }
+
+    compose(begin, end);
+}
+
+void transform_graph::attach(handle id, handle parent)
+{
+    auto& l = links_[id];
+    l.parent = parent;
+    l.next_sibling = invalid;
+
+    auto& first = parent == invalid ? first_root_ : links_[parent].first_child;
+    auto& last = parent == invalid ? last_root_ : links_[parent].last_child;
+
+    l.prev_sibling = last;
+
+    if (last != invalid) {
+        links_[last].next_sibling = id;
+    } else {
+        first = id;
+    }
+
+    last = id;
+}
+
+void transform_graph::detach(handle id)
+{
+    auto& l = links_[id];
+
+    auto& first = l.parent == invalid ? first_root_ : links_[l.parent].first_child;
+    auto& last = l.parent == invalid ? last_root_ : links_[l.parent].last_child;
+
+    if (l.prev_sibling != invalid) {
+        links_[l.prev_sibling].next_sibling = l.next_sibling;
+    } else {
+        first = l.next_sibling;
+    }
+
+    if (l.next_sibling != invalid) {
+        links_[l.next_sibling].prev_sibling = l.prev_sibling;
+    } else {
+        last = l.prev_sibling;
+    }
+
+    l.parent = l.prev_sibling = l.next_sibling = invalid;
+}
+
+void transform_graph::mark(handle id)
+{
+    if (!links_[id].dirty) {
+        links_[id].dirty = true;
+        dirty_.push_back(id);
+    }
+}
+
+void transform_graph::sort()
+{
+    // Depth first walk over the links, dead slots are dropped
+    vector<handle> order;
+    order.reserve(alive_);
+
+    for (auto root = first_root_; root != invalid; root = links_[root].next_sibling) {
+        auto h = root;
+
+        for (;;) {
+            order.push_back(h);
+
+            if (links_[h].first_child != invalid) {
+                h = links_[h].first_child;
+                continue;
+            }
+
+            while (h != root && links_[h].next_sibling == invalid) {
+                h = links_[h].parent;
+            }
+
+            if (h == root)
+                break;
+
+            h = links_[h].next_sibling;
+        }
+    }
+
+    const auto count = u32(order.size());
+
+    locals sorted;
+    sorted.resize(count);
+
+    world_.resize(count);
+    parents_.assign(count, invalid);
+    sizes_.assign(count, 1);
+    handles_ = order;
+
+    for (u32 i = 0; i < count; i++) {
+        auto& l = links_[order[i]];
+
+        sorted.copy(i, locals_, l.slot);
+        l.slot = i;
+
+        // Parents are visited first, their slot is already updated
+        if (l.parent != invalid) {
+            parents_[i] = links_[l.parent].slot;
+        }
+    }
+
+    for (auto i = count; i-- > 0;) {
+        if (parents_[i] != invalid) {
+            sizes_[parents_[i]] += sizes_[i];
+        }
+    }
+
+    locals_ = std::move(sorted);
+    sorted_ = true;
+}
+
+void transform_graph::compose(u32 begin, u32 end)
+{
+    if (begin >= end)
+        return;
+
+    auto* out = &world_[0][0][0];
+    auto i = begin;
+
+    for (; i + wide::width <= end; i += wide::width) {
+        compose_batch<wide>(locals_, i, out + i * 16);
+    }
+
+    for (; i < end; i++) {
+        compose_batch<scalar>(locals_, i, out + i * 16);
+    }
+
+    // Parents precede children, so they're final by the time a child reads them
+    for (i = begin; i < end; i++) {
+        if (parents_[i] != invalid) {
+            multiply(out + parents_[i] * 16, out + i * 16, out + i * 16);
+        }
+    }
+
+    updated_ += end - begin;
+    updated_ranges_.push_back({ begin, end });
+}
+} // namespace bnr
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <utility>
+
+#include <banner/core/math.hpp>
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief Parent/child transforms stored as parallel arrays in depth first order, so
+ * parents always come before their children and every subtree is a contiguous range.
+ *
+ * Changing a node marks its subtree dirty, `update` only recomputes the dirty ranges.
+ * Local matrices are composed several nodes at a time with SSE/AVX2. Attaching a node
+ * anywhere but the end of the order is deferred to a single re-sort in `update`.
+ */
+struct transform_graph
+{
+    using handle = u32;
+
+    static constexpr handle invalid = ~0u;
+
+    handle create(handle parent = invalid);
+
+    /**
+     * @brief Destroys the node and all of its children.
+     */
+    void destroy(handle id);
+
+    void set_parent(handle id, handle parent);
+    handle parent(handle id) const { return links_[id].parent; }
+
+    /**
+     * @brief False for `invalid`, destroyed & out of range handles.
+     */
+    bool alive(handle id) const { return id < links_.size() && links_[id].alive; }
+
+    void set_position(handle id, const v3& position);
+    void set_rotation(handle id, const quat& rotation);
+    void set_scale(handle id, const v3& scale);
+
+    v3 position(handle id) const;
+    quat rotation(handle id) const;
+    v3 scale(handle id) const;
+
+    /**
+     * @brief World matrix as of the last `update`.
+     */
+    const mat4& world(handle id) const { return world_[links_[id].slot]; }
+
+    void update();
+
+    u32 size() const { return alive_; }
+
+    /**
+     * @brief Nodes recomputed by the last `update`.
+     */
+    u32 updated() const { return updated_; }
+
+    /**
+     * @brief Calls `f(handle)` for every node recomputed by the last `update`.
+     */
+    template<typename F>
+    void each_updated(F&& f) const
+    {
+        for (const auto [begin, end] : updated_ranges_) {
+            for (auto slot = begin; slot < end; slot++) {
+                f(handles_[slot]);
+            }
+        }
+    }
+
+private:
+    struct link
+    {
+        handle parent{ invalid };
+        handle first_child{ invalid };
+        handle last_child{ invalid };
+        handle prev_sibling{ invalid };
+        handle next_sibling{ invalid };
+        u32 slot{ invalid };
+        bool alive{ false };
+        bool dirty{ false };
+    };
+
+    // Local transforms per slot, split per component
+    struct locals
+    {
+        vector<f32> px, py, pz;
+        vector<f32> rx, ry, rz, rw;
+        vector<f32> sx, sy, sz;
+
+        void push();
+        void resize(u32 count);
+        void copy(u32 dst, const locals& src, u32 src_slot);
+
+        auto all()
+        {
+            return std::array{ &px, &py, &pz, &rx, &ry, &rz, &rw, &sx, &sy, &sz };
+        }
+        auto all() const
+        {
+            return std::array{ &px, &py, &pz, &rx, &ry, &rz, &rw, &sx, &sy, &sz };
+        }
+    };
+
+    void attach(handle id, handle parent);
+    void detach(handle id);
+    void mark(handle id);
+
+    void sort();
+    void compose(u32 begin, u32 end);
+
+    vector<link> links_;
+    vector<handle> free_;
+    handle first_root_{ invalid };
+    handle last_root_{ invalid };
+
+    // Per slot
+    locals locals_;
+    vector<mat4> world_;
+    vector<u32> parents_;
+    vector<u32> sizes_;
+    vector<handle> handles_;
+
+    vector<handle> dirty_;
+    vector<u32> dirty_slots_;
+    bool sorted_{ true };
+    u32 alive_{ 0 };
+    u32 updated_{ 0 };
+    // Slot ranges composed by the last update
+    vector<std::pair<u32, u32>> updated_ranges_;
+};
+} // namespace bnr
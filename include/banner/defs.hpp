@@ -12,6 +12,16 @@
 #error "Unable to determine platform"
 #endif
 
+// SIMD, AVX2 & FMA have to be enabled by the compiler (BANNER_AVX2 in cmake)
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#define SIMD_AVX2
+#endif
+
+#if defined(SIMD_AVX2) || defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE
+#endif
+
 // Assertion
 #define ASSERTS_ENABLED
 #ifdef ASSERTS_ENABLED
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+
+#include <banner/core/types.hpp>
+#include <banner/entity/entity.hpp>
+#include <banner/entity/scheduler.hpp>
+
+namespace bnr {
+namespace detail {
+inline std::atomic<u32>& change_counter()
+{
+    static std::atomic<u32> tick{ 1 };
+    return tick;
+}
+} // namespace detail
+
+/**
+ * @brief Current change tick, the engine advances it once per fixed step.
+ */
+inline u32 change_tick()
+{
+    return detail::change_counter().load(std::memory_order_relaxed);
+}
+
+inline u32 advance_change_tick()
+{
+    return detail::change_counter().fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+/**
+ * @brief Ticks a component was added & last changed at. Components opt into change
+ * detection by holding one as `ticks`, writers call `touch` when they modify it.
+ */
+struct change_ticks
+{
+    u32 added_at{ change_tick() };
+    u32 changed_at{ change_tick() };
+
+    void touch() { changed_at = change_tick(); }
+};
+
+/**
+ * @brief Query filters, only entities whose `T` was changed/added after the tick
+ * passed to `query(world, since, f)` are visited. The filter runs per entity, a
+ * filtered query still walks every entity matching its components, so it saves the
+ * work done per entity & not the iteration. realm has no per-archetype change list
+ * `touch` could feed.
+ */
+template<typename T>
+struct changed
+{
+    T& value;
+
+    T& operator*() const { return value; }
+    T* operator->() const { return &value; }
+};
+
+template<typename T>
+struct added
+{
+    T& value;
+
+    T& operator*() const { return value; }
+    T* operator->() const { return &value; }
+};
+
+namespace detail {
+template<typename A>
+struct change_filter
+{
+    using arg = query_arg<A>;
+
+    static bool passes(arg, u32) { return true; }
+    static arg wrap(arg a) { return a; }
+};
+
+template<typename T>
+struct change_filter<changed<T>>
+{
+    using arg = T&;
+
+    static bool passes(T& value, u32 since) { return value.ticks.changed_at > since; }
+    static changed<T> wrap(T& value) { return { value }; }
+};
+
+template<typename T>
+struct change_filter<added<T>>
+{
+    using arg = T&;
+
+    static bool passes(T& value, u32 since) { return value.ticks.added_at > since; }
+    static added<T> wrap(T& value) { return { value }; }
+};
+
+template<typename F, typename... Args>
+void query_since(world* world, u32 since, F& f, std::tuple<Args...>*)
+{
+    query(world, [&](typename change_filter<Args>::arg... args) {
+        if ((change_filter<Args>::passes(args, since) && ...)) {
+            f(change_filter<Args>::wrap(args)...);
+        }
+    });
+}
+} // namespace detail
+
+/**
+ * @brief Like `query(world, f)` but `f` can take `changed<T>` & `added<T>` filters,
+ * entities have to pass all of them to be visited. O(n) in the entities matching the
+ * components, however few changed.
+ */
+template<typename F>
+void query(world* world, u32 since, F&& f)
+{
+    using args = typename detail::update_traits<decltype(
+        &std::remove_cvref_t<F>::operator())>::args;
+
+    detail::query_since(world, since, f, static_cast<args*>(nullptr));
+}
+} // namespace bnr
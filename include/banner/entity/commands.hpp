@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
+#include <banner/core/jobs.hpp>
+#include <banner/core/types.hpp>
+#include <banner/entity/entity.hpp>
+#include <banner/entity/scheduler.hpp>
+
+namespace bnr {
+/**
+ * @brief Records structural changes (create, destroy, add & remove components) so
+ * systems running in parallel don't touch the world's archetypes. Every job thread
+ * records into its own buffer, `apply` plays them all back at a sync point.
+ *
+ * Creates & component changes are grouped by the archetype they end up in before
+ * they're applied, destroys go last. Commands on the same entity & component keep
+ * the order they were recorded in on one thread.
+ */
+struct commands
+{
+    explicit commands(bnr::jobs* jobs)
+        : buffers_(jobs ? jobs->workers() + 1 : 1)
+    {}
+
+    template<typename... T>
+    void create(T&&... components)
+    {
+        record(kind::create, (component_bit<T>() | ... | 0ull),
+            [... c = std::forward<T>(components)](world* world) mutable {
+                world->create(std::move(c)...);
+            });
+    }
+
+    void destroy(entity e)
+    {
+        record(kind::destroy, 0, [this, e](world* world) {
+            world->destroy(e);
+            destroyed_.push_back(e);
+        });
+    }
+
+    template<typename T>
+    void add(entity e, T&& component)
+    {
+        using type = std::remove_cvref_t<T>;
+        record(kind::change, component_bit<T>(),
+            [e, c = std::forward<T>(component)](world* world) mutable {
+                world->add<type>(e, std::move(c));
+            });
+    }
+
+    template<typename T>
+    void remove(entity e)
+    {
+        using type = std::remove_cvref_t<T>;
+        record(kind::change, component_bit<T>(), [this, e](world* world) {
+            world->remove<type>(e);
+            removed_[detail::component_id<type>()].push_back(e);
+        });
+    }
+
+    /**
+     * @brief Plays back & clears every buffer, must not overlap with recording.
+     */
+    void apply(world* world)
+    {
+        pending_.clear();
+        destroyed_.clear();
+
+        for (auto& [id, entities] : removed_) {
+            entities.clear();
+        }
+
+        auto gather = [&](vector<command>& recorded) {
+            for (auto& cmd : recorded) {
+                pending_.push_back(std::move(cmd));
+            }
+            recorded.clear();
+        };
+
+        for (auto& buf : buffers_) {
+            gather(buf.recorded);
+        }
+        gather(overflow_);
+
+        // Stable, so one thread's commands on the same component stay in order
+        std::stable_sort(
+            pending_.begin(), pending_.end(), [](const auto& a, const auto& b) {
+                return a.type != b.type ? a.type < b.type : a.key < b.key;
+            });
+
+        for (auto& cmd : pending_) {
+            cmd.run(world);
+        }
+
+        applied_ = u32(pending_.size());
+        pending_.clear();
+    }
+
+    /**
+     * @brief Commands played back by the last `apply`.
+     */
+    u32 applied() const { return applied_; }
+
+    /**
+     * @brief Entities that had `T` removed by the last `apply`, destroyed ones are
+     * only in `destroyed`.
+     */
+    template<typename T>
+    const vector<entity>& removed() const
+    {
+        static const vector<entity> none;
+
+        const auto it = removed_.find(detail::component_id<std::remove_cvref_t<T>>());
+        return it == removed_.end() ? none : it->second;
+    }
+
+    const vector<entity>& destroyed() const { return destroyed_; }
+
+private:
+    enum class kind
+    {
+        create,
+        change,
+        destroy
+    };
+
+    struct command
+    {
+        kind type;
+        // Created component set or the changed component, groups similar moves
+        u64 key;
+        fn<void(world*)> run;
+    };
+
+    struct alignas(64) buffer
+    {
+        vector<command> recorded;
+    };
+
+    template<typename T>
+    static u64 component_bit()
+    {
+        return 1ull << (detail::component_id<std::remove_cvref_t<T>>() % 64);
+    }
+
+    void record(kind type, u64 key, fn<void(world*)> run)
+    {
+        const auto index = jobs::thread_index();
+
+        if (index < buffers_.size()) {
+            buffers_[index].recorded.push_back({ type, key, std::move(run) });
+            return;
+        }
+
+        // Threads outside the job system share a locked buffer
+        std::lock_guard lock{ overflow_mutex_ };
+        overflow_.push_back({ type, key, std::move(run) });
+    }
+
+    vector<buffer> buffers_;
+
+    std::mutex overflow_mutex_;
+    vector<command> overflow_;
+
+    vector<command> pending_;
+    u32 applied_{ 0 };
+
+    std::unordered_map<u32, vector<entity>> removed_;
+    vector<entity> destroyed_;
+};
+} // namespace bnr
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <banner/core/geometry.hpp>
+#include <banner/core/math.hpp>
+#include <banner/core/types.hpp>
+#include <banner/entity/changes.hpp>
+#include <glm/ext/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace bnr {
+/**
+ * @brief Change tracked, call `ticks.touch()` after moving an entity so the spatial
+ * index picks it up.
+ */
+struct transform
+{
+    v3 position{ 0.f };
+    quat rotation{ 1.f, 0.f, 0.f, 0.f };
+    v3 scale{ 1.f };
+
+    change_ticks ticks;
+
+    mat4 matrix() const
+    {
+        const auto translation = glm::translate(mat4{ 1.f }, position);
+        return glm::scale(translation * glm::mat4_cast(rotation), scale);
+    }
+};
+
+/**
+ * @brief Node of the engine's `transform_graph`, used instead of a `transform` by
+ * entities that are part of a hierarchy. Their bounds proxy follows the node once
+ * it's passed to `spatial_index::follow`.
+ */
+struct scene_node
+{
+    u32 id{ ~0u };
+
+    void reset_handles() { id = ~0u; }
+};
+
+/**
+ * @brief Local space bounds, `proxy` is handed out by `spatial_index::insert`. The
+ * engine removes it when the entity is destroyed or loses its `bounds`.
+ */
+struct bounds
+{
+    aabb local;
+    u32 proxy{ ~0u };
+
+    void reset_handles() { proxy = ~0u; }
+};
+
+/**
+ * @brief Ids handed out by `renderer::add_mesh` & `renderer::add_material`.
+ */
+struct renderable
+{
+    u32 mesh{ 0 };
+    u32 material{ 0 };
+};
+} // namespace bnr
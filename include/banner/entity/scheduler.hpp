@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+
+#include <banner/core/jobs.hpp>
+#include <banner/core/types.hpp>
+#include <banner/entity/entity.hpp>
+
+namespace bnr {
+namespace detail {
+template<typename T>
+struct update_traits;
+
+template<typename S, typename... Args>
+struct update_traits<void (S::*)(Args...)>
+{
+    using args = std::tuple<Args...>;
+};
+
+template<typename S, typename... Args>
+struct update_traits<void (S::*)(Args...) const> : update_traits<void (S::*)(Args...)>
+{};
+
+// Non-const references are writes, everything else only reads
+template<typename T>
+constexpr bool is_write =
+    std::is_lvalue_reference_v<T> && !std::is_const_v<std::remove_reference_t<T>>;
+
+template<typename T>
+using query_arg = std::conditional_t<std::is_reference_v<T>, T, const T&>;
+
+inline u32 next_component_id()
+{
+    static std::atomic<u32> next{ 0 };
+    return next++;
+}
+
+template<typename T>
+u32 component_id()
+{
+    static const u32 id = next_component_id();
+    return id;
+}
+} // namespace detail
+
+/**
+ * @brief Runs systems in parallel. Read & write sets are derived from the
+ * `update` signatures (`T&` writes, `const T&` & values read), systems that don't
+ * conflict share a stage and run as jobs. Systems that conflict keep
+ * their insertion order.
+ *
+ * Queries that matched more than `options::chunk_size` entities last update are
+ * split into chunks across threads, systems that aren't safe to call concurrently
+ * can opt out with `static constexpr bool serial = true;`.
+ *
+ * Systems must not create or destroy entities during `update`, they record those in
+ * `commands` instead.
+ */
+struct scheduler
+{
+    struct options
+    {
+        bool parallel{ true };
+        u32 chunk_size{ 4096 };
+    };
+
+    explicit scheduler(world* world, bnr::jobs* jobs, options opts)
+        : world_{ world }
+        , jobs_{ jobs }
+        , opts_{ opts }
+    {}
+
+    template<typename S, typename... Args>
+    S* insert(Args&&... args)
+    {
+        using node_type = typename node_of<S,
+            typename detail::update_traits<decltype(&S::update)>::args>::type;
+
+        auto node = make_uptr<node_type>(std::forward<Args>(args)...);
+        auto instance = &node->instance;
+
+        systems_.push_back(std::move(node));
+        dirty_ = true;
+
+        return instance;
+    }
+
+    void update()
+    {
+        if (dirty_) {
+            build();
+        }
+
+        for (auto& stage : stages_) {
+            run(stage);
+        }
+    }
+
+    u32 stage_count()
+    {
+        if (dirty_) {
+            build();
+        }
+        return u32(stages_.size());
+    }
+
+    auto& opts() { return opts_; }
+
+private:
+    struct system
+    {
+        virtual ~system() = default;
+
+        /**
+         * @brief Decides how this update is split, returns the amount of tasks.
+         */
+        virtual u32 prepare(world* world, u32 chunk_size) = 0;
+        virtual void run(world* world, u32 task) = 0;
+
+        bool conflicts(const system& other) const
+        {
+            auto overlaps = [](const vector<u32>& a, const vector<u32>& b) {
+                return std::any_of(a.begin(), a.end(), [&](u32 id) {
+                    return std::find(b.begin(), b.end(), id) != b.end();
+                });
+            };
+
+            return overlaps(writes, other.writes) || overlaps(writes, other.reads) ||
+                overlaps(reads, other.writes);
+        }
+
+        vector<u32> reads;
+        vector<u32> writes;
+        u32 tasks{ 1 };
+    };
+
+    template<typename S, typename... Args>
+    struct node final : system
+    {
+        template<typename... Ts>
+        explicit node(Ts&&... args)
+            : instance{ std::forward<Ts>(args)... }
+        {
+            (add_access<Args>(), ...);
+        }
+
+        u32 prepare(world* world, u32 chunk_size) override
+        {
+            constexpr bool serial = requires { requires S::serial; };
+
+            chunk_ = chunk_size;
+            gathered_ = !serial && count_ > chunk_size;
+
+            if (!gathered_)
+                return 1;
+
+            // realm doesn't expose its chunks, gather the matches and split those
+            refs_.clear();
+            query(world, [&](detail::query_arg<Args>... args) {
+                refs_.emplace_back(&args...);
+            });
+
+            count_ = u32(refs_.size());
+            return std::max(1u, (count_ + chunk_ - 1) / chunk_);
+        }
+
+        void run(world* world, u32 task) override
+        {
+            if (!gathered_) {
+                u32 count{ 0 };
+                query(world, [&](detail::query_arg<Args>... args) {
+                    instance.update(args...);
+                    count++;
+                });
+                count_ = count;
+                return;
+            }
+
+            const auto begin = task * chunk_;
+            const auto end = std::min(begin + chunk_, count_);
+
+            for (auto i = begin; i < end; i++) {
+                std::apply([&](auto*... ptrs) { instance.update(*ptrs...); }, refs_[i]);
+            }
+        }
+
+        S instance;
+
+    private:
+        template<typename T>
+        void add_access()
+        {
+            const auto id = detail::component_id<std::remove_cvref_t<T>>();
+            (detail::is_write<T> ? writes : reads).push_back(id);
+        }
+
+        vector<std::tuple<std::remove_reference_t<detail::query_arg<Args>>*...>> refs_;
+        u32 count_{ 0 };
+        u32 chunk_{ 1 };
+        bool gathered_{ false };
+    };
+
+    template<typename S, typename Tuple>
+    struct node_of;
+
+    template<typename S, typename... Args>
+    struct node_of<S, std::tuple<Args...>>
+    {
+        using type = node<S, Args...>;
+    };
+
+    void build()
+    {
+        // Every system goes after the last stage holding a system it conflicts with
+        vector<u32> stage_of(systems_.size(), 0);
+        stages_.clear();
+
+        for (u32 i = 0; i < systems_.size(); i++) {
+            for (u32 j = 0; j < i; j++) {
+                if (systems_[i]->conflicts(*systems_[j])) {
+                    stage_of[i] = std::max(stage_of[i], stage_of[j] + 1);
+                }
+            }
+
+            if (stage_of[i] >= stages_.size()) {
+                stages_.resize(stage_of[i] + 1);
+            }
+
+            stages_[stage_of[i]].push_back(systems_[i].get());
+        }
+
+        dirty_ = false;
+    }
+
+    void run(const vector<system*>& stage)
+    {
+        u32 total{ 0 };
+        for (auto* sys : stage) {
+            sys->tasks = sys->prepare(world_, opts_.chunk_size);
+            total += sys->tasks;
+        }
+
+        if (!opts_.parallel || !jobs_ || total == 1) {
+            for (auto* sys : stage) {
+                for (u32 t = 0; t < sys->tasks; t++) {
+                    sys->run(world_, t);
+                }
+            }
+            return;
+        }
+
+        // The calling thread takes the first task and helps out until the stage is done
+        jobs::counter done;
+
+        for (u32 s = 0; s < stage.size(); s++) {
+            for (u32 t = (s == 0 ? 1 : 0); t < stage[s]->tasks; t++) {
+                jobs_->run([sys = stage[s], t, this]() { sys->run(world_, t); }, &done);
+            }
+        }
+
+        stage.front()->run(world_, 0);
+        jobs_->wait(done);
+    }
+
+    world* world_;
+    bnr::jobs* jobs_;
+    options opts_;
+
+    vector<uptr<system>> systems_;
+    vector<vector<system*>> stages_;
+    bool dirty_{ false };
+};
+} // namespace bnr
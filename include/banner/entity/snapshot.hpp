@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+
+#include <banner/core/types.hpp>
+#include <banner/entity/changes.hpp>
+#include <banner/entity/entity.hpp>
+#include <banner/util/debug.hpp>
+#include <banner/util/file.hpp>
+
+namespace bnr {
+/**
+ * @brief Binary world snapshots. Every registered archetype is written as one raw,
+ * 64 byte aligned array per component behind a small header, loading maps the file
+ * & copies the components straight out of the mapping.
+ *
+ * realm doesn't expose its archetype storage, so archetypes are registered with
+ * `add<T...>()` & captured with a query. An entity matched by several sets sharing a
+ * component is saved once, in the largest set, sets without a common component can't
+ * be told apart so register the full component set of every archetype. For the same
+ * reason loading still creates entities one by one, only the file access is mapped.
+ * Components have to be trivially copyable.
+ *
+ * Entity ids & handles into engine side structures aren't preserved. Components
+ * holding one clear it in `reset_handles()`, which `load` calls on every restored
+ * component that has it, e.g. `bounds::proxy` & `scene_node::id` come back invalid
+ * and have to be inserted into the spatial index & transform graph again. Change
+ * ticks are restamped with the current tick, restored components count as added.
+ *
+ * layout: header | group (columns...)... | padding | column data...
+ */
+struct snapshot
+{
+    static constexpr u32 magic = 0x534e5242; // BRNS
+    static constexpr u32 version = 1;
+    static constexpr u64 alignment = 64;
+
+    struct header
+    {
+        u32 magic;
+        u32 version;
+        u32 groups;
+        u32 reserved;
+    };
+
+    struct group
+    {
+        u64 signature;
+        u32 columns;
+        u32 count;
+    };
+
+    struct column
+    {
+        u64 type;
+        u64 stride;
+        // From the start of the file, a multiple of `alignment`
+        u64 offset;
+    };
+
+    template<typename... T>
+    void add()
+    {
+        static_assert((std::is_trivially_copyable_v<T> && ...),
+            "snapshot components have to be trivially copyable");
+
+        for (const auto& a : archetypes_) {
+            if (a.signature == signature<T...>()) {
+                debug::err("Archetype registered twice with the snapshot");
+                return;
+            }
+        }
+
+        archetypes_.push_back({ signature<T...>(), { type_hash<T>()... },
+            { u64(sizeof(T))... }, &gather<T...>, &restore<T...> });
+    }
+
+    /**
+     * @brief Writes every registered archetype of `world` to `filename`.
+     */
+    bool save(world* world, str_ref filename) const
+    {
+        vector<group> groups;
+        vector<column> columns;
+        vector<vector<char>> data;
+
+        // Largest sets first so entities land in their most specific archetype,
+        // components already written are skipped by the smaller sets
+        vector<const archetype_info*> order;
+        for (const auto& a : archetypes_) {
+            order.push_back(&a);
+        }
+        std::stable_sort(order.begin(), order.end(),
+            [](auto* a, auto* b) { return a->types.size() > b->types.size(); });
+
+        std::unordered_set<const void*> saved;
+
+        for (const auto* a : order) {
+            const auto first = u32(data.size());
+            data.resize(first + a->types.size());
+
+            const auto count = a->gather(world, data.data() + first, saved);
+            groups.push_back({ a->signature, u32(a->types.size()), count });
+
+            for (u32 i = 0; i < a->types.size(); i++) {
+                columns.push_back({ a->types[i], a->strides[i], 0 });
+            }
+        }
+
+        // Column data starts after the headers, every block aligned
+        auto offset = align(sizeof(header) + groups.size() * sizeof(group) +
+            columns.size() * sizeof(column));
+
+        for (u32 i = 0; i < columns.size(); i++) {
+            columns[i].offset = offset;
+            offset = align(offset + data[i].size());
+        }
+
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            debug::err("Failed to write snapshot: %s", filename.c_str());
+            return false;
+        }
+
+        const header head{ magic, version, u32(groups.size()), 0 };
+        write(file, &head, sizeof(head));
+
+        u32 next{ 0 };
+        for (const auto& g : groups) {
+            write(file, &g, sizeof(g));
+            write(file, columns.data() + next, g.columns * sizeof(column));
+            next += g.columns;
+        }
+
+        for (u32 i = 0; i < columns.size(); i++) {
+            pad(file, columns[i].offset);
+            write(file, data[i].data(), data[i].size());
+        }
+
+        return file.good();
+    }
+
+    /**
+     * @brief Creates the entities stored in `filename`, groups that don't match a
+     * registered archetype are skipped.
+     */
+    bool load(world* world, str_ref filename) const
+    {
+        const mapped_file file(filename);
+
+        if (!file.valid() || file.size() < sizeof(header))
+            return false;
+
+        const auto base = file.data();
+        const auto head = reinterpret_cast<const header*>(base);
+
+        if (head->magic != magic || head->version != version) {
+            debug::err("Invalid snapshot: %s", filename.c_str());
+            return false;
+        }
+
+        u64 cursor{ sizeof(header) };
+
+        for (u32 g = 0; g < head->groups; g++) {
+            if (cursor + sizeof(group) > file.size())
+                return false;
+
+            const auto grp = reinterpret_cast<const group*>(base + cursor);
+            const auto cols =
+                reinterpret_cast<const column*>(base + cursor + sizeof(group));
+            cursor += sizeof(group) + grp->columns * sizeof(column);
+
+            if (cursor > file.size())
+                return false;
+
+            const auto a = find(*grp, cols);
+            if (!a)
+                continue;
+
+            vector<const uc8*> arrays(grp->columns);
+            for (u32 i = 0; i < grp->columns; i++) {
+                if (cols[i].offset + cols[i].stride * grp->count > file.size())
+                    return false;
+
+                arrays[i] = base + cols[i].offset;
+            }
+
+            a->restore(world, arrays.data(), grp->count);
+        }
+
+        return true;
+    }
+
+private:
+    struct archetype_info
+    {
+        u64 signature;
+        vector<u64> types;
+        vector<u64> strides;
+
+        u32 (*gather)(world*, vector<char>*, std::unordered_set<const void*>&);
+        void (*restore)(world*, const uc8* const*, u32);
+    };
+
+    // Stable per compiler, unlike the ids handed out at runtime
+    template<typename T>
+    static u64 type_hash()
+    {
+#ifdef _MSC_VER
+        constexpr std::string_view name = __FUNCSIG__;
+#else
+        constexpr std::string_view name = __PRETTY_FUNCTION__;
+#endif
+        u64 hash{ 0xcbf29ce484222325ull };
+        for (const auto c : name) {
+            hash = (hash ^ u64(uc8(c))) * 0x100000001b3ull;
+        }
+        return hash;
+    }
+
+    template<typename... T>
+    static u64 signature()
+    {
+        u64 hash{ 0 };
+        ((hash = hash * 31 + type_hash<T>()), ...);
+        return hash;
+    }
+
+    template<typename... T>
+    static u32 gather(
+        world* world, vector<char>* columns, std::unordered_set<const void*>& saved)
+    {
+        u32 count{ 0 };
+        query(world, [&](const T&... components) {
+            if ((saved.contains(&components) || ...))
+                return;
+
+            (saved.insert(&components), ...);
+
+            u32 i{ 0 };
+            ((append(columns[i++], &components, sizeof(T))), ...);
+            count++;
+        });
+
+        return count;
+    }
+
+    static void append(vector<char>& column, const void* data, u64 size)
+    {
+        const auto bytes = static_cast<const char*>(data);
+        column.insert(column.end(), bytes, bytes + size);
+    }
+
+    template<typename... T>
+    static void restore(world* world, const uc8* const* arrays, u32 count)
+    {
+        restore_columns<T...>(world, arrays, count, std::index_sequence_for<T...>{});
+    }
+
+    template<typename... T, size_t... I>
+    static void restore_columns(
+        world* world, const uc8* const* arrays, u32 count, std::index_sequence<I...>)
+    {
+        for (u32 i = 0; i < count; i++) {
+            world->create(read<T>(arrays[I] + i * sizeof(T))...);
+        }
+    }
+
+    template<typename T>
+    static T read(const uc8* src)
+    {
+        T value;
+        std::memcpy(&value, src, sizeof(T));
+
+        if constexpr (requires(T& v) { v.reset_handles(); }) {
+            value.reset_handles();
+        }
+
+        if constexpr (requires(T& v) { v.ticks = change_ticks{}; }) {
+            value.ticks = change_ticks{};
+        }
+
+        return value;
+    }
+
+    const archetype_info* find(const group& g, const column* cols) const
+    {
+        for (const auto& a : archetypes_) {
+            if (a.signature != g.signature || a.types.size() != g.columns)
+                continue;
+
+            for (u32 i = 0; i < g.columns; i++) {
+                if (a.types[i] != cols[i].type || a.strides[i] != cols[i].stride)
+                    return nullptr;
+            }
+            return &a;
+        }
+        return nullptr;
+    }
+
+    static u64 align(u64 offset) { return (offset + alignment - 1) & ~(alignment - 1); }
+
+    static void write(std::ofstream& file, const void* data, u64 size)
+    {
+        file.write(static_cast<const char*>(data), std::streamsize(size));
+    }
+
+    static void pad(std::ofstream& file, u64 offset)
+    {
+        static const char zeros[alignment]{};
+        const auto at = u64(file.tellp());
+        write(file, zeros, offset - at);
+    }
+
+    vector<archetype_info> archetypes_;
+};
+} // namespace bnr
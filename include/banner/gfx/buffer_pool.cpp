@@ -0,0 +1,205 @@
+#include <banner/gfx/buffer_pool.hpp>
+#include <banner/gfx/deletion_queue.hpp>
+#include <banner/gfx/memory.hpp>
+#include <banner/gfx/vk_utils.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+using vk_utils::success;
+
+buffer_pool::buffer_pool(memory* memory, vk::BufferUsageFlags usage,
+    VmaMemoryUsage memory_usage, vk::DeviceSize alignment, vk::DeviceSize block_size)
+    : memory_{ memory }
+    , usage_{ usage }
+    , memory_usage_{ memory_usage }
+    , alignment_{ alignment }
+    , block_size_{ block_size }
+{}
+
+buffer_pool::~buffer_pool()
+{
+    for (u32 i = 0; i < blocks_.size(); i++) {
+        destroy_block(i);
+    }
+    blocks_.clear();
+}
+
+buffer_pool::slice buffer_pool::allocate(vk::DeviceSize size)
+{
+    slice result{};
+
+    for (u32 i = 0; i < blocks_.size(); i++) {
+        if (allocate_in(i, size, result)) {
+            return result;
+        }
+    }
+
+    // Oversized requests get a block of their own
+    const auto block_size =
+        std::max(block_size_, (size + alignment_ - 1) & ~(alignment_ - 1));
+
+    const auto idx = create_block(block_size);
+
+    if (idx == ~0u || !allocate_in(idx, size, result)) {
+        debug::err("Failed to sub-allocate buffer of size %llu", u64(size));
+        return {};
+    }
+
+    return result;
+}
+
+void buffer_pool::free(slice& slice)
+{
+    if (!slice.valid() || slice.block >= blocks_.size() || !blocks_[slice.block])
+        return;
+
+    blocks_[slice.block]->owners.erase(slice.node);
+    release(slice.block, slice.node, slice.size);
+
+    slice = {};
+}
+
+void buffer_pool::free(slice& slice, deletion_queue* deletions)
+{
+    if (!slice.valid() || slice.block >= blocks_.size() || !blocks_[slice.block])
+        return;
+
+    // Unowned ranges aren't moved by the defragmenter
+    blocks_[slice.block]->owners.erase(slice.node);
+
+    deletions->push([this, block = slice.block, node = slice.node, size = slice.size]() {
+        release(block, node, size);
+    });
+
+    slice = {};
+}
+
+void buffer_pool::bind(slice& slice)
+{
+    if (!slice.valid())
+        return;
+
+    blocks_[slice.block]->owners[slice.node] = &slice;
+}
+
+u32 buffer_pool::block_count() const
+{
+    u32 count{ 0 };
+    for (auto& blk : blocks_) {
+        count += blk ? 1 : 0;
+    }
+    return count;
+}
+
+vk::DeviceSize buffer_pool::used() const
+{
+    vk::DeviceSize used{ 0 };
+    for (auto& blk : blocks_) {
+        used += blk ? blk->allocator.used() : 0;
+    }
+    return used;
+}
+
+vk::DeviceSize buffer_pool::capacity() const
+{
+    vk::DeviceSize capacity{ 0 };
+    for (auto& blk : blocks_) {
+        capacity += blk ? blk->allocator.capacity() : 0;
+    }
+    return capacity;
+}
+
+bool buffer_pool::allocate_in(u32 idx, vk::DeviceSize size, slice& result)
+{
+    auto& blk = blocks_[idx];
+    if (!blk || blk->moving)
+        return false;
+
+    u64 offset{ 0 };
+    auto node = blk->allocator.allocate(size, alignment_, offset);
+
+    if (node == tlsf::invalid)
+        return false;
+
+    result.buffer = blk->buffer;
+    result.offset = offset;
+    result.size = size;
+    result.block = idx;
+    result.node = node;
+    result.mapped = blk->mapped ? static_cast<uc8*>(blk->mapped) + offset : nullptr;
+
+    memory_->track(memory::category_of(usage_), size);
+    return true;
+}
+
+void buffer_pool::release(u32 idx, tlsf::handle node, vk::DeviceSize size)
+{
+    auto& blk = blocks_[idx];
+    blk->allocator.free(node);
+
+    memory_->untrack(memory::category_of(usage_), size);
+
+    // Keep regular blocks around for reuse, release dedicated ones directly unless vma
+    // is still moving them
+    if (blk->allocator.empty() && dedicated(idx) && !blk->moving) {
+        destroy_block(idx);
+    }
+}
+
+u32 buffer_pool::create_block(vk::DeviceSize size)
+{
+    auto blk = make_uptr<block>(block{ {}, nullptr, nullptr, tlsf{ size } });
+
+    VmaAllocationCreateInfo allocation_create_info{
+        .flags{ VMA_ALLOCATION_CREATE_MAPPED_BIT },
+        .usage{ memory_usage_ },
+    };
+
+    auto buffer_create_info = block_info(size);
+    VmaAllocationInfo allocation_info{};
+
+    if (!success(vmaCreateBuffer(memory_->allocator(),
+            reinterpret_cast<VkBufferCreateInfo*>(&buffer_create_info),
+            &allocation_create_info, reinterpret_cast<VkBuffer*>(&blk->buffer),
+            &blk->allocation, &allocation_info))) {
+        debug::err("Failed to create pool block of size %llu", u64(size));
+        return ~0u;
+    }
+
+    blk->mapped = allocation_info.pMappedData;
+
+    // Reuse released block slots so slice indices stay stable
+    for (u32 i = 0; i < blocks_.size(); i++) {
+        if (!blocks_[i]) {
+            blocks_[i] = std::move(blk);
+            return i;
+        }
+    }
+
+    blocks_.push_back(std::move(blk));
+    return u32(blocks_.size() - 1);
+}
+
+void buffer_pool::destroy_block(u32 idx)
+{
+    auto& blk = blocks_[idx];
+
+    if (!blk)
+        return;
+
+    vmaDestroyBuffer(memory_->allocator(), blk->buffer, blk->allocation);
+    blk.reset();
+}
+
+vk::BufferCreateInfo buffer_pool::block_info(vk::DeviceSize size) const
+{
+    // Device local blocks can be relocated by the defragmenter
+    auto usage = usage_;
+    if (memory_usage_ == VMA_MEMORY_USAGE_GPU_ONLY) {
+        usage |=
+            vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eTransferDst;
+    }
+
+    return { {}, size, usage, vk::SharingMode::eExclusive };
+}
+} // namespace bnr
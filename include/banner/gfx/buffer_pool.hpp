@@ -0,0 +1,104 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <vk_mem_alloc.h>
+
+#include <banner/core/types.hpp>
+#include <banner/util/tlsf.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct memory;
+struct deletion_queue;
+
+/**
+ * @brief Large backing buffers of one usage class that hand out (buffer, offset, size)
+ * slices through a tlsf sub-allocator.
+ */
+struct buffer_pool
+{
+    friend struct defragmenter;
+
+    static constexpr vk::DeviceSize default_block_size = 16 * 1024 * 1024;
+
+    struct slice
+    {
+        vk::Buffer buffer;
+        vk::DeviceSize offset{ 0 };
+        vk::DeviceSize size{ 0 };
+        void* mapped{ nullptr };
+
+        u32 block{ ~0u };
+        tlsf::handle node{ tlsf::invalid };
+
+        bool valid() const { return (bool)buffer; }
+    };
+
+    explicit buffer_pool(memory* memory, vk::BufferUsageFlags usage,
+        VmaMemoryUsage memory_usage, vk::DeviceSize alignment,
+        vk::DeviceSize block_size = default_block_size);
+    ~buffer_pool();
+
+    /**
+     * @brief Returns an invalid slice when no block could hold `size`, callers have to
+     * check `valid()` before writing to it.
+     */
+    slice allocate(vk::DeviceSize size);
+    void free(slice& slice);
+
+    /**
+     * @brief Unbinds `slice` right away but keeps its range allocated until
+     * `deletions` retires it, for slices frames in flight may still read.
+     */
+    void free(slice& slice, deletion_queue* deletions);
+
+    /**
+     * @brief Registers a long lived slice so it can be relocated by the defragmenter,
+     * the slice must stay at the same address until it's freed.
+     */
+    void bind(slice& slice);
+
+    auto usage() const { return usage_; }
+    auto memory_usage() const { return memory_usage_; }
+    auto alignment() const { return alignment_; }
+
+    u32 block_count() const;
+    vk::DeviceSize used() const;
+    vk::DeviceSize capacity() const;
+
+private:
+    struct block
+    {
+        vk::Buffer buffer;
+        VmaAllocation allocation{ nullptr };
+        void* mapped{ nullptr };
+        tlsf allocator;
+        std::unordered_map<tlsf::handle, slice*> owners;
+        // Relocated by vma, no new ranges until the move has completed
+        bool moving{ false };
+    };
+
+    bool allocate_in(u32 idx, vk::DeviceSize size, slice& result);
+    void release(u32 idx, tlsf::handle node, vk::DeviceSize size);
+
+    bool dedicated(u32 idx) const
+    {
+        return blocks_[idx]->allocator.capacity() > block_size_;
+    }
+
+    u32 create_block(vk::DeviceSize size);
+    void destroy_block(u32 idx);
+
+    vk::BufferCreateInfo block_info(vk::DeviceSize size) const;
+
+    memory* memory_;
+
+    vk::BufferUsageFlags usage_;
+    VmaMemoryUsage memory_usage_;
+    vk::DeviceSize alignment_;
+    vk::DeviceSize block_size_;
+
+    vector<uptr<block>> blocks_;
+};
+} // namespace bnr
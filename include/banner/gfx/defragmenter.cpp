@@ -0,0 +1,302 @@
+#include <algorithm>
+
+#include <banner/gfx/defragmenter.hpp>
+#include <banner/gfx/graphics.hpp>
+#include <banner/gfx/renderer.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+defragmenter::defragmenter(graphics* ctx, renderer* renderer, options opts)
+    : ctx_{ ctx }
+    , renderer_{ renderer }
+    , opts_{ opts }
+{}
+
+defragmenter::~defragmenter()
+{
+    // Expects the device to be idle at this point
+    retire(u64(-1));
+}
+
+void defragmenter::step(vk::CommandBuffer cmd)
+{
+    retire(renderer_->completed_frame());
+
+    if (!opts_.enabled)
+        return;
+
+    budget budget{ opts_.max_moves, opts_.max_bytes, clock::now() + opts_.time_budget };
+    bool moved{ false };
+
+    for (auto pool : device_pools()) {
+        if (budget.exhausted())
+            break;
+
+        moved |= compact(pool, cmd, budget);
+    }
+
+    // Only one vma pass may be in flight at a time, and it shouldn't read ranges
+    // that were just written by the compaction above
+    if (!pending_ && !moved && !budget.exhausted()) {
+        moved |= relocate_blocks(cmd, budget);
+    }
+
+    if (!moved)
+        return;
+
+    vk::MemoryBarrier barrier{ vk::AccessFlagBits::eTransferWrite,
+        vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead |
+            vk::AccessFlagBits::eUniformRead | vk::AccessFlagBits::eShaderRead |
+            vk::AccessFlagBits::eTransferRead };
+
+    cmd.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+        vk::PipelineStageFlagBits::eVertexInput |
+            vk::PipelineStageFlagBits::eVertexShader |
+            vk::PipelineStageFlagBits::eFragmentShader |
+            vk::PipelineStageFlagBits::eTransfer,
+        {}, barrier, nullptr, nullptr);
+}
+
+bool defragmenter::compact(buffer_pool* pool, vk::CommandBuffer cmd, budget& budget)
+{
+    auto& blocks = pool->blocks_;
+
+    // Pick the least occupied regular block as source
+    u32 source{ ~0u };
+    u32 regular{ 0 };
+    f32 lowest{ opts_.occupancy };
+
+    for (u32 i = 0; i < blocks.size(); i++) {
+        if (!blocks[i] || pool->dedicated(i) || blocks[i]->moving)
+            continue;
+
+        regular++;
+
+        const auto& allocator = blocks[i]->allocator;
+
+        if (allocator.empty())
+            continue;
+
+        const auto occupancy = f32(allocator.used()) / f32(allocator.capacity());
+
+        if (occupancy < lowest) {
+            lowest = occupancy;
+            source = i;
+        }
+    }
+
+    if (source == ~0u || regular < 2)
+        return false;
+
+    auto& owners = blocks[source]->owners;
+    vector<tlsf::handle> moved;
+
+    for (auto& [node, owner] : owners) {
+        const auto size = owner->size;
+
+        if (budget.exhausted() || size > budget.bytes)
+            break;
+
+        // Never grow the pool to make room, only fill existing blocks
+        buffer_pool::slice target{};
+        bool found{ false };
+
+        for (u32 i = 0; i < blocks.size() && !found; i++) {
+            if (i != source && blocks[i] && !pool->dedicated(i)) {
+                found = pool->allocate_in(i, size, target);
+            }
+        }
+
+        if (!found)
+            break;
+
+        cmd.copyBuffer(owner->buffer, target.buffer,
+            vk::BufferCopy{ owner->offset, target.offset, size });
+
+        retired_ranges_.push_back({ renderer_->frame(), pool, source, node, size });
+
+        *owner = target;
+        blocks[target.block]->owners[target.node] = owner;
+        moved.push_back(node);
+
+        budget.spend(1, size);
+        stats_.moves++;
+        stats_.bytes += size;
+    }
+
+    for (auto node : moved) {
+        owners.erase(node);
+    }
+
+    return !moved.empty();
+}
+
+bool defragmenter::relocate_blocks(vk::CommandBuffer cmd, budget& budget)
+{
+    if (opts_.max_blocks == 0)
+        return false;
+
+    vector<VmaAllocation> allocations;
+    vector<std::pair<buffer_pool*, u32>> sources;
+    vk::DeviceSize largest{ 0 };
+    std::pair<vk::DeviceSize, vk::DeviceSize> layout{ 0, 0 };
+
+    // Dedicated blocks are released as soon as they're empty, which mustn't happen
+    // while vma moves them, so only regular blocks take part
+    for (auto pool : device_pools()) {
+        for (u32 i = 0; i < pool->blocks_.size(); i++) {
+            if (pool->blocks_[i] && !pool->dedicated(i)) {
+                allocations.push_back(pool->blocks_[i]->allocation);
+                sources.push_back({ pool, i });
+                largest = std::max(largest, pool->blocks_[i]->allocator.capacity());
+                layout.first += pool->blocks_[i]->allocator.capacity();
+            }
+        }
+    }
+
+    // Space vma could move blocks into opens up whenever any allocation goes away
+    for (const auto& heap : ctx_->memory()->stats().heaps) {
+        layout.second += heap.usage;
+    }
+
+    // Nothing moved last time & no allocation came or went since, it wouldn't move
+    // anything now either
+    if (allocations.size() < 2 || layout == settled_)
+        return false;
+
+    vector<VkBool32> changed(allocations.size(), VK_FALSE);
+
+    VmaDefragmentationInfo2 info{};
+    info.allocationCount = u32(allocations.size());
+    info.pAllocations = allocations.data();
+    info.pAllocationsChanged = changed.data();
+    // Blocks only move as a whole, a byte budget below one block would never move any
+    info.maxGpuBytesToMove = largest * opts_.max_blocks;
+    info.maxGpuAllocationsToMove = std::min(budget.moves, opts_.max_blocks);
+    info.commandBuffer = cmd;
+
+    VmaDefragmentationStats stats{};
+    const auto allocator = ctx_->memory()->allocator();
+    const auto result = vmaDefragmentationBegin(allocator, &info, &stats, &pending_);
+
+    if (result < 0) {
+        debug::warn("Failed to begin memory defragmentation");
+        pending_ = nullptr;
+        return false;
+    }
+
+    // Frames keep drawing from the old buffers until the copies have executed, the
+    // new ones are only created & bound once vma ended the pass
+    for (u32 i = 0; i < changed.size(); i++) {
+        if (changed[i]) {
+            auto [pool, block] = sources[i];
+            pool->blocks_[block]->moving = true;
+            relocated_.push_back({ pool, block });
+        }
+    }
+
+    budget.spend(stats.allocationsMoved, stats.bytesMoved);
+    stats_.block_moves += stats.allocationsMoved;
+    pending_frame_ = renderer_->frame();
+    settled_ = stats.allocationsMoved == 0 ? layout : decltype(layout){};
+
+    if (result == VK_SUCCESS) {
+        // Nothing was recorded for the gpu
+        end_pass();
+    }
+
+    return stats.allocationsMoved > 0;
+}
+
+void defragmenter::rebind(buffer_pool* pool, u32 block)
+{
+    auto& blk = pool->blocks_[block];
+
+    // The old buffer may still be referenced by frames in flight
+    ctx_->deletions()->push([device = ctx_->device(), buffer = blk->buffer]() {
+        device->vk().destroyBuffer(
+            buffer, device->callbacks(vk::ObjectType::eDeviceMemory));
+    });
+
+    // Has to match the callbacks vma destroys pool buffers with
+    blk->buffer = ctx_->device()->vk().createBuffer(
+        pool->block_info(blk->allocator.capacity()),
+        ctx_->device()->callbacks(vk::ObjectType::eDeviceMemory));
+
+    vmaBindBufferMemory(ctx_->memory()->allocator(), blk->allocation, blk->buffer);
+
+    VmaAllocationInfo allocation_info{};
+    vmaGetAllocationInfo(ctx_->memory()->allocator(), blk->allocation, &allocation_info);
+    blk->mapped = allocation_info.pMappedData;
+
+    for (auto& [node, owner] : blk->owners) {
+        owner->buffer = blk->buffer;
+    }
+}
+
+void defragmenter::end_pass()
+{
+    vmaDefragmentationEnd(ctx_->memory()->allocator(), pending_);
+    pending_ = nullptr;
+
+    for (auto [pool, block] : relocated_) {
+        pool->blocks_[block]->moving = false;
+        rebind(pool, block);
+    }
+    relocated_.clear();
+}
+
+void defragmenter::retire(u64 completed)
+{
+    vector<buffer_pool*> touched;
+
+    std::erase_if(retired_ranges_, [&](const retired_range& range) {
+        if (range.frame > completed)
+            return false;
+
+        range.pool->release(range.block, range.node, range.size);
+        touched.push_back(range.pool);
+        return true;
+    });
+
+    if (pending_ && pending_frame_ <= completed) {
+        end_pass();
+    }
+
+    // Blocks can't be freed while vma is moving them
+    if (!pending_) {
+        for (auto pool : touched) {
+            trim(pool);
+        }
+    }
+}
+
+void defragmenter::trim(buffer_pool* pool)
+{
+    auto& blocks = pool->blocks_;
+
+    // Keep one block around so the pool doesn't thrash
+    auto live = pool->block_count();
+
+    for (u32 i = 0; i < blocks.size() && live > 1; i++) {
+        if (blocks[i] && blocks[i]->allocator.empty()) {
+            pool->destroy_block(i);
+            stats_.released_blocks++;
+            live--;
+        }
+    }
+}
+
+vector<buffer_pool*> defragmenter::device_pools() const
+{
+    vector<buffer_pool*> pools;
+
+    for (auto& [key, pool] : ctx_->memory()->pools_) {
+        if (pool->memory_usage() == VMA_MEMORY_USAGE_GPU_ONLY) {
+            pools.push_back(pool.get());
+        }
+    }
+
+    return pools;
+}
+} // namespace bnr
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <algorithm>
+
+#include <vk_mem_alloc.h>
+
+#include <banner/core/types.hpp>
+#include <banner/gfx/buffer_pool.hpp>
+#include <banner/util/time.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct graphics;
+struct renderer;
+
+/**
+ * @brief Incrementally compacts device local buffer pools. Every frame a bounded
+ * amount of slices is copied out of sparsely used blocks and pool blocks are
+ * relocated through the vma defragmentation api. Old ranges are retired once the
+ * renderer has finished the frame the copies were recorded in, old buffers go through
+ * the deletion queue.
+ *
+ * Only pooled buffers are covered. Textures own dedicated vma images that nothing
+ * here moves, streamed textures are instead released & re-created by
+ * `texture_streamer` as their detail changes.
+ */
+struct defragmenter
+{
+    struct options
+    {
+        bool enabled{ true };
+        u32 max_moves{ 64 };
+        vk::DeviceSize max_bytes{ 8 * 1024 * 1024 };
+        // Pool blocks relocated through vma per pass, moved as a whole
+        u32 max_blocks{ 1 };
+        us time_budget{ 250 };
+        // Blocks used less than this are drained into other blocks
+        f32 occupancy{ 0.5f };
+    };
+
+    struct statistics
+    {
+        u64 moves{ 0 };
+        u64 bytes{ 0 };
+        u64 block_moves{ 0 };
+        u64 released_blocks{ 0 };
+    };
+
+    explicit defragmenter(graphics* ctx, renderer* renderer, options opts);
+    ~defragmenter();
+
+    /**
+     * @brief Records this frame's moves, has to run before any command that reads
+     * pooled buffers in the same submission.
+     */
+    void step(vk::CommandBuffer cmd);
+
+    auto& opts() { return opts_; }
+    const auto& stats() const { return stats_; }
+
+private:
+    struct budget
+    {
+        u32 moves;
+        vk::DeviceSize bytes;
+        time_point deadline;
+
+        bool exhausted() const
+        {
+            return moves == 0 || bytes == 0 || clock::now() >= deadline;
+        }
+
+        void spend(u32 count, vk::DeviceSize size)
+        {
+            moves -= std::min(moves, count);
+            bytes -= std::min(bytes, size);
+        }
+    };
+
+    struct retired_range
+    {
+        u64 frame;
+        buffer_pool* pool;
+        u32 block;
+        tlsf::handle node;
+        vk::DeviceSize size;
+    };
+
+    bool compact(buffer_pool* pool, vk::CommandBuffer cmd, budget& budget);
+    bool relocate_blocks(vk::CommandBuffer cmd, budget& budget);
+    void end_pass();
+    void rebind(buffer_pool* pool, u32 block);
+
+    void retire(u64 completed);
+    void trim(buffer_pool* pool);
+
+    vector<buffer_pool*> device_pools() const;
+
+    graphics* ctx_;
+    renderer* renderer_;
+    options opts_;
+    statistics stats_;
+
+    vector<retired_range> retired_ranges_;
+
+    VmaDefragmentationContext pending_{ nullptr };
+    u64 pending_frame_{ 0 };
+    // Rebound once vma has finished the pending pass
+    vector<std::pair<buffer_pool*, u32>> relocated_;
+    // Pool block capacity & heap usage at the last vma pass that moved nothing
+    std::pair<vk::DeviceSize, vk::DeviceSize> settled_{ 0, 0 };
+};
+} // namespace bnr
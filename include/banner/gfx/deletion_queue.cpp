@@ -0,0 +1,59 @@
+#include <algorithm>
+
+#include <banner/gfx/deletion_queue.hpp>
+
+namespace bnr {
+deletion_queue::~deletion_queue()
+{
+    flush();
+}
+
+void deletion_queue::push(fn<void()> destroy)
+{
+    std::lock_guard lock{ mutex_ };
+    entries_.push_back({ frame_, std::move(destroy) });
+}
+
+void deletion_queue::set_frame(u64 frame)
+{
+    std::lock_guard lock{ mutex_ };
+    frame_ = frame;
+}
+
+void deletion_queue::retire(u64 completed)
+{
+    // Destroyed outside of the lock, destructors may push again
+    vector<entry> retired;
+
+    {
+        std::lock_guard lock{ mutex_ };
+
+        // Entries are pushed in frame order
+        const auto end =
+            std::find_if(entries_.begin(), entries_.end(), [&](const entry& e) {
+                return e.frame > completed;
+            });
+
+        std::move(entries_.begin(), end, std::back_inserter(retired));
+        entries_.erase(entries_.begin(), end);
+    }
+
+    for (auto& e : retired) {
+        e.destroy();
+    }
+}
+
+void deletion_queue::flush()
+{
+    // Destroying can queue more, e.g. a pool releasing its blocks
+    while (size() > 0) {
+        retire(u64(-1));
+    }
+}
+
+u32 deletion_queue::size() const
+{
+    std::lock_guard lock{ mutex_ };
+    return u32(entries_.size());
+}
+} // namespace bnr
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mutex>
+
+#include <banner/core/types.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+/**
+ * @brief Defers the destruction of gpu objects until every frame that may still use
+ * them has finished. Objects are tagged with the last frame handed to the gpu when
+ * they're pushed, the renderer advances the frame & retires the completed ones.
+ */
+struct deletion_queue
+{
+    deletion_queue() = default;
+    ~deletion_queue();
+
+    deletion_queue(const deletion_queue&) = delete;
+    deletion_queue& operator=(const deletion_queue&) = delete;
+
+    /**
+     * @brief Queues `destroy`, safe to call from any thread.
+     */
+    void push(fn<void()> destroy);
+
+    template<typename T, typename D>
+    void push(vk::UniqueHandle<T, D>&& handle)
+    {
+        if (!handle)
+            return;
+
+        // fn has to be copyable, unique handles aren't
+        auto owned = std::make_shared<vk::UniqueHandle<T, D>>(std::move(handle));
+        push([owned]() { owned->reset(); });
+    }
+
+    /**
+     * @brief Frame currently recorded, objects pushed from now on wait for it.
+     */
+    void set_frame(u64 frame);
+
+    /**
+     * @brief Destroys everything pushed up to frame `completed`.
+     */
+    void retire(u64 completed);
+
+    /**
+     * @brief Destroys everything, the device has to be idle.
+     */
+    void flush();
+
+    u64 frame() const { return frame_; }
+    u32 size() const;
+
+private:
+    struct entry
+    {
+        u64 frame;
+        fn<void()> destroy;
+    };
+
+    mutable std::mutex mutex_;
+    vector<entry> entries_;
+    u64 frame_{ 0 };
+};
+} // namespace bnr
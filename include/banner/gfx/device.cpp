@@ -1,4 +1,5 @@
 #pragma once
+#include <algorithm>
 #include <unordered_set>
 
 #include <banner/defs.hpp>
@@ -23,17 +24,25 @@ device::device(
     }
 
     vk_physical_ = gpu;
+    host_ = opts.host;
     features_ = vk_physical_.getFeatures();
     props_ = vk_physical_.getMemoryProperties();
+    limits_ = vk_physical_.getProperties().limits;
 
     vk::DeviceCreateInfo device_info{ vk::DeviceCreateFlags(), u32(queue_infos.size()),
         queue_infos.data(), u32(opts.layers.size()), opts.layers.data(),
         u32(opts.extensions.size()), opts.extensions.data(), &features_ };
 
-    vk_device_ = vk_physical_.createDeviceUnique(device_info);
+    vk_device_ =
+        vk_physical_.createDeviceUnique(device_info, callbacks(vk::ObjectType::eDevice));
+    extensions_ = { opts.extensions.begin(), opts.extensions.end() };
 
     queue_ = std::make_unique<device::queue_data>(
         this, indices.graphics_family.value(), indices.present_family.value());
 }
 
+bool device::has_extension(cstr name) const
+{
+    return std::find(extensions_.begin(), extensions_.end(), name) != extensions_.end();
+}
 } // namespace bnr
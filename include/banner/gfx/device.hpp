@@ -1,6 +1,7 @@
 #pragma once
 
 #include <banner/core/types.hpp>
+#include <banner/gfx/host_allocator.hpp>
 #include <vulkan/vulkan.hpp>
 
 namespace bnr {
@@ -10,6 +11,7 @@ struct device
     {
         vector<cstr> extensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
         vector<cstr> layers{ "VK_LAYER_KHRONOS_validation" };
+        const host_allocator* host{ nullptr };
     };
 
     explicit device(const vk::PhysicalDevice& device, const vk::SurfaceKHR surface,
@@ -59,11 +61,26 @@ struct device
     const auto& queue() const { return *queue_.get(); }
     const auto& features() { return features_; }
     const auto& props() { return props_; }
+    const auto& limits() { return limits_; }
+
+    bool has_extension(cstr name) const;
+
+    /**
+     * @brief Host allocation callbacks for objects of `type`, null when host
+     * allocations aren't tracked.
+     */
+    const vk::AllocationCallbacks* callbacks(vk::ObjectType type) const
+    {
+        return host_ ? host_->callbacks(type) : nullptr;
+    }
 
 private:
     vk::PhysicalDevice vk_physical_;
     vk::PhysicalDeviceFeatures features_;
     vk::PhysicalDeviceMemoryProperties props_;
+    vk::PhysicalDeviceLimits limits_;
+    vector<str> extensions_;
+    const host_allocator* host_;
     vk::UniqueDevice vk_device_;
     uptr<queue_data> queue_;
 };
@@ -10,41 +10,57 @@
 
 namespace bnr {
 const vector<cstr> graphics::device_extensions{ VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+const vector<cstr> graphics::optional_device_extensions{
+    VK_EXT_MEMORY_BUDGET_EXTENSION_NAME
+};
 const vector<cstr> graphics::validation_layers{ "VK_LAYER_KHRONOS_validation" };
 
-graphics::graphics(window* window)
+graphics::graphics(
+    window* window, host_allocator::options host, swapchain::policy present)
     : window_{ window }
+    , present_{ present }
+    , host_{ make_uptr<host_allocator>(host) }
+    , deletions_{ make_uptr<deletion_queue>() }
 {
     create_instance();
     create_debugger();
     create_device();
     create_pool();
 
-    window_->on_resize.connect<&graphics::resize_swapchain>(*this);
+    window_->events.on<"resize", &graphics::resize_swapchain>(*this);
 }
 
 graphics::~graphics()
 {
+    if (device_) {
+        device_->vk().waitIdle();
+    }
+    deletions_->flush();
+
     // Destroy debugger
     if (debugger_) {
         const auto destroy = PFN_vkDestroyDebugUtilsMessengerEXT(
             vkGetInstanceProcAddr(instance_.get(), "vkDestroyDebugUtilsMessengerEXT"));
-        destroy(instance_.get(), debugger_, nullptr);
+        destroy(instance_.get(), debugger_,
+            reinterpret_cast<const VkAllocationCallbacks*>(
+                host_->callbacks(vk::ObjectType::eDebugUtilsMessengerEXT)));
     }
 
     for (auto& shader : shader_modules_) {
-        device_->vk().destroyShaderModule(shader);
+        device_->vk().destroyShaderModule(
+            shader, device_->callbacks(vk::ObjectType::eShaderModule));
     }
 
     shader_modules_.clear();
 
-    window_->on_resize.disconnect<&graphics::resize_swapchain>(*this);
+    window_->events.off<"resize", &graphics::resize_swapchain>(*this);
     transfer_pool_.reset();
 }
 
 vk::ShaderModule graphics::load_shader(str_ref filename)
 {
-    shader_modules_.push_back(vk_utils::load_shader(filename, &device_->vk()));
+    shader_modules_.push_back(vk_utils::load_shader(
+        filename, &device_->vk(), device_->callbacks(vk::ObjectType::eShaderModule)));
     return shader_modules_.back();
 }
 
@@ -69,7 +85,8 @@ void graphics::create_instance()
         u32(validation_layers.size()), validation_layers.data(),
         u32(instance_extensions.size()), instance_extensions.data() };
 
-    instance_ = vk::createInstanceUnique(instance_info);
+    instance_ = vk::createInstanceUnique(
+        instance_info, host_->callbacks(vk::ObjectType::eInstance));
 
     ASSERT(instance_, "Failed to create vulkan instance!");
 
@@ -78,8 +95,10 @@ void graphics::create_instance()
 
 void graphics::create_surface()
 {
-    surface_ =
-        vk::UniqueSurfaceKHR(window_->create_surface(instance_.get()), instance_.get());
+    const auto callbacks = host_->callbacks(vk::ObjectType::eSurfaceKHR);
+
+    surface_ = vk::UniqueSurfaceKHR(window_->create_surface(instance_.get(), callbacks),
+        { instance_.get(), callbacks });
 
     ASSERT(surface_, "Failed to create surface!");
 }
@@ -98,10 +117,17 @@ void graphics::create_device()
     create_surface();
 
     // Make device options
-    device::options opts{ device_extensions, validation_layers };
+    device::options opts{ device_extensions, validation_layers, host_.get() };
 
     for (const auto& dev : devices) {
         if (vk_utils::is_device_suitable(dev, surface_.get(), device_extensions)) {
+            // Enable optional extensions the device supports
+            for (auto ext : optional_device_extensions) {
+                if (vk_utils::check_device_extensions(dev, { ext })) {
+                    opts.extensions.push_back(ext);
+                }
+            }
+
             // Create logical device
             device_ = std::make_unique<bnr::device>(dev, surface_.get(), opts);
             break;
@@ -115,15 +141,17 @@ void graphics::create_device()
     }
 
     // Create swapchain
-    swapchain_ = std::make_unique<bnr::swapchain>(
-        device_.get(), surface_.get(), window_->framebuffer_size());
+    swapchain_ = std::make_unique<bnr::swapchain>(device_.get(), deletions_.get(),
+        surface_.get(), window_->framebuffer_size(), present_);
 
     ASSERT(swapchain_, "Failed to create swapchain!");
 
-    swapchain_->on_recreate.connect([&]() { debug::log("Recreated swapchain"); });
+    swapchain_->events.on<"recreate">([]() { debug::log("Recreated swapchain"); });
 
     // Initializing VMA
-    memory_ = std::make_unique<bnr::memory>(device_.get());
+    memory_ = std::make_unique<bnr::memory>(device_.get(), instance_.get());
+
+    samplers_ = std::make_unique<sampler_cache>(device_.get());
 
     debug::trace("Initialized vulkan graphics ...");
 }
@@ -132,7 +160,8 @@ void graphics::create_pool()
 {
     // TODO: get a special index for transfer operations
     transfer_pool_ = (device()->vk().createCommandPoolUnique(
-        { vk::CommandPoolCreateFlagBits::eTransient, device()->queue().graphics_index }));
+        { vk::CommandPoolCreateFlagBits::eTransient, device()->queue().graphics_index },
+        device()->callbacks(vk::ObjectType::eCommandPool)));
 }
 
 void graphics::command(fn<void(vk::CommandBuffer)>&& callback)
@@ -184,7 +213,9 @@ void graphics::create_debugger()
 
     ASSERT(create, "Failed to create debug messenger!");
 
-    create(instance_.get(), (VkDebugUtilsMessengerCreateInfoEXT*)&debug_info, nullptr,
+    create(instance_.get(), (VkDebugUtilsMessengerCreateInfoEXT*)&debug_info,
+        reinterpret_cast<const VkAllocationCallbacks*>(
+            host_->callbacks(vk::ObjectType::eDebugUtilsMessengerEXT)),
         (VkDebugUtilsMessengerEXT*)&debugger_);
 
     ASSERT(debugger_, "Failed to create debug messenger");
@@ -3,8 +3,11 @@
 #include <vector>
 
 #include <banner/core/types.hpp>
+#include <banner/gfx/deletion_queue.hpp>
 #include <banner/gfx/device.hpp>
+#include <banner/gfx/host_allocator.hpp>
 #include <banner/gfx/memory.hpp>
+#include <banner/gfx/sampler_cache.hpp>
 #include <banner/gfx/swapchain.hpp>
 #include <banner/gfx/vk_utils.hpp>
 #include <vulkan/vulkan.hpp>
@@ -17,13 +20,18 @@ class graphics
 public:
     static const vector<cstr> validation_layers;
     static const vector<cstr> device_extensions;
+    static const vector<cstr> optional_device_extensions;
 
-    graphics(window* window);
+    graphics(window* window, host_allocator::options host = {},
+        swapchain::policy present = swapchain::policy::low_latency);
     ~graphics();
 
+    auto host() { return host_.get(); }
     auto device() { return device_.get(); }
     auto swapchain() { return swapchain_.get(); }
     auto memory() { return memory_.get(); }
+    auto samplers() { return samplers_.get(); }
+    auto deletions() { return deletions_.get(); }
 
     void command(fn<void(vk::CommandBuffer)>&&);
 
@@ -32,6 +40,10 @@ public:
 
 private:
     window* window_;
+    swapchain::policy present_;
+
+    // Outlives every object created with its callbacks
+    uptr<host_allocator> host_;
 
     vk::UniqueInstance instance_;
     vk::UniqueSurfaceKHR surface_;
@@ -40,6 +52,9 @@ private:
     uptr<bnr::device> device_;
     uptr<bnr::swapchain> swapchain_;
     uptr<bnr::memory> memory_;
+    uptr<sampler_cache> samplers_;
+    // Declared last, flushed before anything it may reference is destroyed
+    uptr<deletion_queue> deletions_;
 
     // Temp storage of shaders
     vector<vk::ShaderModule> shader_modules_;
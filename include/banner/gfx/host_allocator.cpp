@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <banner/defs.hpp>
+#include <banner/gfx/host_allocator.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+namespace {
+// Stored right in front of every allocation
+struct header
+{
+    void* base;
+    size_t size;
+    size_t alignment;
+};
+
+constexpr u32 surface_index = u32(vk::ObjectType::eCommandPool) + 1;
+constexpr u32 swapchain_index = surface_index + 1;
+constexpr u32 debug_messenger_index = surface_index + 2;
+
+void* aligned_allocate(size_t size, size_t alignment)
+{
+    alignment = std::max(alignment, alignof(header));
+
+    auto* base = static_cast<uc8*>(std::malloc(size + alignment + sizeof(header)));
+    if (!base)
+        return nullptr;
+
+    auto address = reinterpret_cast<uintptr_t>(base + sizeof(header));
+    address = (address + alignment - 1) & ~uintptr_t(alignment - 1);
+
+    auto* memory = reinterpret_cast<void*>(address);
+    reinterpret_cast<header*>(memory)[-1] = { base, size, alignment };
+
+    return memory;
+}
+
+header& header_of(void* memory)
+{
+    return reinterpret_cast<header*>(memory)[-1];
+}
+
+void update_peak(std::atomic<u64>& peak, u64 value)
+{
+    auto current = peak.load(std::memory_order_relaxed);
+    while (value > current && !peak.compare_exchange_weak(current, value)) {}
+}
+} // namespace
+
+host_allocator::host_allocator(options opts)
+    : opts_{ opts }
+{
+    for (u32 i = 0; i < type_count; i++) {
+        trackers_[i].owner = this;
+
+        callbacks_[i] = vk::AllocationCallbacks{ &trackers_[i], &allocate, &reallocate,
+            &free, &internal_allocate, &internal_free };
+    }
+}
+
+const vk::AllocationCallbacks* host_allocator::callbacks(vk::ObjectType type) const
+{
+    return opts_.enabled ? &callbacks_[index_of(type)] : nullptr;
+}
+
+const host_allocator::counters& host_allocator::stats(vk::ObjectType type) const
+{
+    return trackers_[index_of(type)].stats;
+}
+
+u64 host_allocator::allocations() const
+{
+    u64 count{ 0 };
+    for (auto& t : trackers_) {
+        count += t.stats.allocations + t.stats.reallocations;
+    }
+    return count;
+}
+
+u64 host_allocator::bytes() const
+{
+    u64 total{ 0 };
+    for (auto& t : trackers_) {
+        total += t.stats.bytes;
+    }
+    return total;
+}
+
+void host_allocator::end_frame()
+{
+    const auto total = allocations();
+
+    frame_allocations_ = total - frame_start_;
+    frame_start_ = total;
+    frame_++;
+
+    if (opts_.assert_steady_state && frame_ > opts_.warmup_frames) {
+        ASSERT(frame_allocations_ == 0, "Driver host allocation in a steady state frame");
+    }
+}
+
+str host_allocator::type_name(vk::ObjectType type)
+{
+    switch (index_of(type)) {
+    case surface_index:
+        return "SurfaceKHR";
+    case swapchain_index:
+        return "SwapchainKHR";
+    case debug_messenger_index:
+        return "DebugUtilsMessengerEXT";
+    case 0:
+        return "Unknown";
+    default:
+        return vk::to_string(type);
+    }
+}
+
+u32 host_allocator::index_of(vk::ObjectType type)
+{
+    if (u32(type) <= u32(vk::ObjectType::eCommandPool))
+        return u32(type);
+
+    switch (type) {
+    case vk::ObjectType::eSurfaceKHR:
+        return surface_index;
+    case vk::ObjectType::eSwapchainKHR:
+        return swapchain_index;
+    case vk::ObjectType::eDebugUtilsMessengerEXT:
+        return debug_messenger_index;
+    default:
+        return 0;
+    }
+}
+
+void* host_allocator::allocate(
+    void* user, size_t size, size_t alignment, VkSystemAllocationScope)
+{
+    auto& stats = static_cast<tracker*>(user)->stats;
+
+    auto* memory = aligned_allocate(size, alignment);
+    if (!memory)
+        return nullptr;
+
+    stats.allocations++;
+    update_peak(stats.peak_bytes, stats.bytes += size);
+
+    return memory;
+}
+
+void* host_allocator::reallocate(void* user, void* original, size_t size,
+    size_t alignment, VkSystemAllocationScope scope)
+{
+    if (!original)
+        return allocate(user, size, alignment, scope);
+
+    if (size == 0) {
+        free(user, original);
+        return nullptr;
+    }
+
+    auto& stats = static_cast<tracker*>(user)->stats;
+    const auto old_size = header_of(original).size;
+
+    auto* memory = aligned_allocate(size, alignment);
+    if (!memory)
+        return nullptr;
+
+    std::memcpy(memory, original, std::min(size, old_size));
+    std::free(header_of(original).base);
+
+    stats.reallocations++;
+    stats.bytes -= old_size;
+    update_peak(stats.peak_bytes, stats.bytes += size);
+
+    return memory;
+}
+
+void host_allocator::free(void* user, void* memory)
+{
+    if (!memory)
+        return;
+
+    auto& stats = static_cast<tracker*>(user)->stats;
+    auto& h = header_of(memory);
+
+    stats.frees++;
+    stats.bytes -= h.size;
+
+    std::free(h.base);
+}
+
+void host_allocator::internal_allocate(
+    void* user, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+    static_cast<tracker*>(user)->stats.internal_bytes += size;
+}
+
+void host_allocator::internal_free(
+    void* user, size_t size, VkInternalAllocationType, VkSystemAllocationScope)
+{
+    static_cast<tracker*>(user)->stats.internal_bytes -= size;
+}
+} // namespace bnr
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <banner/core/types.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+/**
+ * @brief Instrumented `VkAllocationCallbacks`. Every object type gets its own
+ * callbacks whose user data points at the counters for that type, so driver host
+ * allocations can be attributed & counted per frame.
+ */
+struct host_allocator
+{
+    struct options
+    {
+        bool enabled{ false };
+        // Asserts that no host allocations happen once warmed up
+        bool assert_steady_state{ false };
+        u32 warmup_frames{ 120 };
+    };
+
+    struct counters
+    {
+        std::atomic<u64> allocations{ 0 };
+        std::atomic<u64> reallocations{ 0 };
+        std::atomic<u64> frees{ 0 };
+        std::atomic<u64> bytes{ 0 };
+        std::atomic<u64> peak_bytes{ 0 };
+        std::atomic<u64> internal_bytes{ 0 };
+    };
+
+    // Core object types are contiguous, the extension types we create are appended
+    static constexpr u32 type_count = u32(vk::ObjectType::eCommandPool) + 4;
+
+    explicit host_allocator(options opts);
+
+    host_allocator(const host_allocator&) = delete;
+    host_allocator& operator=(const host_allocator&) = delete;
+
+    const vk::AllocationCallbacks* callbacks(vk::ObjectType type) const;
+
+    const counters& stats(vk::ObjectType type) const;
+
+    u64 allocations() const;
+    u64 bytes() const;
+
+    /**
+     * @brief Closes the current frame, allocations made since the previous call are
+     * reported through `frame_allocations`.
+     */
+    void end_frame();
+
+    auto frame_allocations() const { return frame_allocations_; }
+    auto frame() const { return frame_; }
+
+    static str type_name(vk::ObjectType type);
+
+private:
+    struct tracker
+    {
+        host_allocator* owner;
+        counters stats;
+    };
+
+    static u32 index_of(vk::ObjectType type);
+
+    static void* VKAPI_PTR allocate(
+        void* user, size_t size, size_t alignment, VkSystemAllocationScope scope);
+    static void* VKAPI_PTR reallocate(void* user, void* original, size_t size,
+        size_t alignment, VkSystemAllocationScope scope);
+    static void VKAPI_PTR free(void* user, void* memory);
+    static void VKAPI_PTR internal_allocate(void* user, size_t size,
+        VkInternalAllocationType type, VkSystemAllocationScope scope);
+    static void VKAPI_PTR internal_free(void* user, size_t size,
+        VkInternalAllocationType type, VkSystemAllocationScope scope);
+
+    options opts_;
+
+    std::array<tracker, type_count> trackers_;
+    std::array<vk::AllocationCallbacks, type_count> callbacks_;
+
+    u64 frame_{ 0 };
+    u64 frame_start_{ 0 };
+    u64 frame_allocations_{ 0 };
+};
+} // namespace bnr
@@ -1,24 +1,158 @@
+#include <algorithm>
+
 #include <banner/gfx/memory.hpp>
 #include <banner/util/debug.hpp>
 
 namespace bnr {
-memory::memory(device* device)
+memory::memory(bnr::device* device, vk::Instance instance)
+    : device_{ device }
+    , budget_enabled_{ device->has_extension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) }
 {
     // clang-format off
     VmaAllocatorCreateInfo info
     {
+        .flags = budget_enabled_ ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = device->physical(),
-        .device = device->vk()
+        .device = device->vk(),
+        .pAllocationCallbacks = reinterpret_cast<const VkAllocationCallbacks*>(
+            device->callbacks(vk::ObjectType::eDeviceMemory)),
+        .instance = instance,
+        .vulkanApiVersion = VK_API_VERSION_1_2
     };
+    // clang-format on
 
     vmaCreateAllocator(&info, &vma_allocator_);
+
+    const auto& props = device_->props();
+    stats_.heaps.resize(props.memoryHeapCount);
+
+    for (u32 i = 0; i < props.memoryHeapCount; i++) {
+        stats_.heaps[i].device_local =
+            bool(props.memoryHeaps[i].flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+    }
+
+    update();
 }
 
 memory::~memory()
 {
+    pools_.clear();
+
     if (vma_allocator_) {
         vmaDestroyAllocator(vma_allocator_);
         vma_allocator_ = nullptr;
     }
 };
+
+buffer_pool* memory::pool(vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage)
+{
+    const pool_key key{ VkBufferUsageFlags(usage), memory_usage };
+
+    auto it = pools_.find(key);
+
+    if (it == pools_.end()) {
+        it = pools_
+                 .emplace(key,
+                     make_uptr<buffer_pool>(
+                         this, usage, memory_usage, pool_alignment(usage, memory_usage)))
+                 .first;
+    }
+
+    return it->second.get();
+}
+
+void memory::update()
+{
+    // Budgets are refreshed by vma when the frame index changes
+    vmaSetCurrentFrameIndex(vma_allocator_, ++frame_);
+
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetBudget(vma_allocator_, budgets);
+
+    for (u32 i = 0; i < stats_.heaps.size(); i++) {
+        auto& heap = stats_.heaps[i];
+
+        heap.usage = budgets[i].usage;
+        heap.budget = budgets[i].budget;
+        heap.peak = std::max(heap.peak, heap.usage);
+
+        if (heap.budget == 0)
+            continue;
+
+        const auto ratio = f32(heap.usage) / f32(heap.budget);
+
+        if (!heap.pressured && ratio >= pressure_threshold) {
+            heap.pressured = true;
+            on_budget_pressure.fire({ i, heap.usage, heap.budget, ratio });
+        } else if (heap.pressured && ratio < pressure_threshold - pressure_hysteresis) {
+            heap.pressured = false;
+        }
+    }
+}
+
+void memory::track(category c, vk::DeviceSize bytes)
+{
+    auto& stats = stats_.categories[u32(c)];
+
+    stats.allocations++;
+    stats.bytes += bytes;
+    stats.peak_allocations = std::max(stats.peak_allocations, stats.allocations);
+    stats.peak_bytes = std::max(stats.peak_bytes, stats.bytes);
+}
+
+void memory::untrack(category c, vk::DeviceSize bytes)
+{
+    auto& stats = stats_.categories[u32(c)];
+
+    stats.allocations--;
+    stats.bytes -= bytes;
+}
+
+memory::category memory::category_of(vk::BufferUsageFlags usage)
+{
+    if (usage & (vk::BufferUsageFlagBits::eVertexBuffer |
+                    vk::BufferUsageFlagBits::eIndexBuffer)) {
+        return category::mesh;
+    } else if (usage & vk::BufferUsageFlagBits::eUniformBuffer) {
+        return category::uniform;
+    } else if (usage & vk::BufferUsageFlagBits::eTransferSrc) {
+        return category::staging;
+    }
+    return category::other;
+}
+
+vk::DeviceSize memory::available() const
+{
+    vk::DeviceSize available{ 0 };
+
+    for (const auto& heap : stats_.heaps) {
+        if (heap.device_local && heap.budget > heap.usage) {
+            available += heap.budget - heap.usage;
+        }
+    }
+
+    return available;
+}
+
+vk::DeviceSize memory::pool_alignment(
+    vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage)
+{
+    const auto& limits = device_->limits();
+
+    vk::DeviceSize alignment{ tlsf::min_alignment };
+
+    if (usage & vk::BufferUsageFlagBits::eUniformBuffer) {
+        alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+    }
+
+    if (usage & vk::BufferUsageFlagBits::eStorageBuffer) {
+        alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+    }
+
+    if (memory_usage != VMA_MEMORY_USAGE_GPU_ONLY) {
+        alignment = std::max(alignment, limits.nonCoherentAtomSize);
+    }
+
+    return alignment;
+}
 } // namespace bnr
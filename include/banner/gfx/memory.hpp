@@ -1,18 +1,115 @@
 #pragma once
 
+#include <array>
+#include <map>
+#include <utility>
+
 #include <vk_mem_alloc.h>
 
+#include <banner/gfx/buffer_pool.hpp>
 #include <banner/gfx/device.hpp>
+#include <banner/util/signal.hpp>
 
 namespace bnr {
 struct memory
 {
-    explicit memory(device* device);
+    friend struct defragmenter;
+
+    enum class category : u32
+    {
+        mesh,
+        texture,
+        staging,
+        uniform,
+        other,
+        count
+    };
+
+    struct heap_stats
+    {
+        vk::DeviceSize usage{ 0 };
+        vk::DeviceSize budget{ 0 };
+        vk::DeviceSize peak{ 0 };
+        bool device_local{ false };
+        // Set once pressure fired, cleared below the threshold minus the hysteresis
+        bool pressured{ false };
+    };
+
+    struct category_stats
+    {
+        u32 allocations{ 0 };
+        u32 peak_allocations{ 0 };
+        vk::DeviceSize bytes{ 0 };
+        vk::DeviceSize peak_bytes{ 0 };
+    };
+
+    struct statistics
+    {
+        vector<heap_stats> heaps;
+        std::array<category_stats, u32(category::count)> categories;
+
+        auto& operator[](category c) const { return categories[u32(c)]; }
+    };
+
+    /**
+     * @brief Fired from `update` once a heap's usage crosses the pressure threshold of
+     * its budget, again only after it dropped below `threshold - hysteresis`.
+     */
+    struct pressure
+    {
+        u32 heap;
+        vk::DeviceSize usage;
+        vk::DeviceSize budget;
+        f32 ratio;
+    };
+
+    explicit memory(bnr::device* device, vk::Instance instance);
     ~memory();
 
     VmaAllocator allocator() const { return vma_allocator_; }
+    auto device() const { return device_; }
+
+    /**
+     * @brief Returns the shared sub-allocation pool for a usage class, pools are
+     * created on first use.
+     */
+    buffer_pool* pool(vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage);
+
+    /**
+     * @brief Refreshes heap budgets, should be called once per frame.
+     */
+    void update();
+
+    void track(category c, vk::DeviceSize bytes);
+    void untrack(category c, vk::DeviceSize bytes);
+
+    static category category_of(vk::BufferUsageFlags usage);
+
+    const auto& stats() const { return stats_; }
+    auto budget_enabled() const { return budget_enabled_; }
+
+    /**
+     * @brief Remaining budget of the device local heaps.
+     */
+    vk::DeviceSize available() const;
+
+    f32 pressure_threshold{ 0.9f };
+    f32 pressure_hysteresis{ 0.05f };
+    signal<void(const pressure&)> on_budget_pressure;
 
 private:
+    using pool_key = std::pair<VkBufferUsageFlags, VmaMemoryUsage>;
+
+    vk::DeviceSize pool_alignment(
+        vk::BufferUsageFlags usage, VmaMemoryUsage memory_usage);
+
+    bnr::device* device_;
     VmaAllocator vma_allocator_;
+
+    std::map<pool_key, uptr<buffer_pool>> pools_;
+
+    statistics stats_;
+    u32 frame_{ 0 };
+    bool budget_enabled_{ false };
 };
 } // namespace bnr
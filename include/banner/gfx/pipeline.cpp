@@ -1,3 +1,4 @@
+#include <banner/gfx/deletion_queue.hpp>
 #include <banner/gfx/device.hpp>
 #include <banner/gfx/graphics.hpp>
 #include <banner/gfx/pipeline.hpp>
@@ -23,26 +24,56 @@ pipeline::pipeline()
     info_.viewport.setPViewports(&viewport_);
 }
 
+pipeline::~pipeline()
+{
+    retire();
+}
+
+void pipeline::retire()
+{
+    if (!deletions_)
+        return;
+
+    deletions_->push(std::move(vk_pipeline_));
+    deletions_->push(std::move(vk_layout_));
+}
+
 void pipeline::create(bnr::subpass* subpass_ptr)
 {
     set_subpass(subpass_ptr);
 
-    const auto device = subpass()->render_pass()->ctx()->device();
+    const auto ctx = subpass()->render_pass()->ctx();
+    const auto device = ctx->device();
     const auto extent = subpass()->render_pass()->extent();
 
+    // Recreated, the old objects may still be bound by frames in flight
+    retire();
+    deletions_ = ctx->deletions();
+
     set_viewport(nullptr, { extent.width, extent.height });
 
     const auto [viewport, rasterization, multisample, depth_stencil, input_assembly,
         vertex_input_state, color_blend, dynamic_state] = info_;
 
+    vector<vk::DescriptorSetLayout> sets;
+    if (frame_layout_) {
+        sets.push_back(frame_layout_);
+    }
+    if (descriptor_layout_) {
+        sets.push_back(descriptor_layout_.get());
+    }
+
     vk_layout_ = device->vk().createPipelineLayoutUnique(
-        { {}, descriptor_layout_ ? 1u : 0u, &descriptor_layout_.get() });
+        { {}, u32(sets.size()), sets.data(), u32(push_constants_.size()),
+            push_constants_.data() },
+        device->callbacks(vk::ObjectType::ePipelineLayout));
 
     vk_pipeline_ = device->vk().createGraphicsPipelineUnique({},
         { {}, u32(shader_stages_.size()), shader_stages_.data(), &vertex_input_state,
             &input_assembly, nullptr, &viewport, &rasterization, &multisample,
             nullptr /*&depth_stencil*/, &color_blend, nullptr, vk_layout_.get(),
-            subpass()->render_pass()->vk(), 0 });
+            subpass()->render_pass()->vk(), 0 },
+        device->callbacks(vk::ObjectType::ePipeline));
 
     ASSERT(vk_pipeline_, "Failed to create pipeline!");
 
@@ -51,9 +82,32 @@ void pipeline::create(bnr::subpass* subpass_ptr)
 
 void pipeline::set_descriptor(vector<vk::DescriptorSetLayoutBinding> bindings)
 {
-    descriptor_layout_ =
-        subpass()->render_pass()->ctx()->device()->vk().createDescriptorSetLayoutUnique(
-            { {}, u32(bindings.size()), bindings.data() });
+    const auto device = subpass()->render_pass()->ctx()->device();
+
+    descriptor_layout_ = device->vk().createDescriptorSetLayoutUnique(
+        { {}, u32(bindings.size()), bindings.data() },
+        device->callbacks(vk::ObjectType::eDescriptorSetLayout));
+}
+
+void pipeline::set_frame_layout(vk::DescriptorSetLayout layout)
+{
+    if (frame_layout_ == layout)
+        return;
+
+    frame_layout_ = layout;
+
+    if (vk_pipeline_) {
+        create(subpass_);
+    }
+}
+
+void pipeline::bind_descriptor_set(
+    vk::CommandBuffer buffer, vk::DescriptorSet set, const vector<u32>& dynamic_offsets)
+{
+    const auto first = frame_layout_ ? 1u : 0u;
+
+    buffer.bindDescriptorSets(
+        vk::PipelineBindPoint::eGraphics, vk_layout_.get(), first, set, dynamic_offsets);
 }
 
 vk::PipelineColorBlendAttachmentState pipeline::default_color_blend_attachment()
@@ -5,6 +5,7 @@
 #include <vulkan/vulkan.hpp>
 
 namespace bnr {
+struct deletion_queue;
 struct subpass;
 struct swapchain;
 struct render_pass;
@@ -19,6 +20,7 @@ struct pipeline
     using cb_signature = void(vk::CommandBuffer);
 
     explicit pipeline();
+    ~pipeline();
 
     struct create_info
     {
@@ -63,6 +65,26 @@ struct pipeline
 
     void set_descriptor(vector<vk::DescriptorSetLayoutBinding> bindings);
 
+    /**
+     * @brief Adds `layout` as set 0 of the pipeline layout, the own descriptor set
+     * then binds at set 1. Recreates the pipeline when it already exists.
+     */
+    void set_frame_layout(vk::DescriptorSetLayout layout);
+    auto frame_layout() const { return frame_layout_; }
+
+    void add_push_constant(vk::ShaderStageFlags stages, u32 size)
+    {
+        const auto offset = push_constants_.empty()
+            ? 0u
+            : push_constants_.back().offset + push_constants_.back().size;
+        push_constants_.push_back({ stages, offset, size });
+    }
+
+    const auto& push_constants() const { return push_constants_; }
+
+    void bind_descriptor_set(vk::CommandBuffer buffer, vk::DescriptorSet set,
+        const vector<u32>& dynamic_offsets = {});
+
     fn<cb_signature> on_process;
 
 private:
@@ -70,18 +92,24 @@ private:
     void process(vk::CommandBuffer buffer, uv2 extent);
     void bind_buffer(vk::CommandBuffer buffer);
     void set_viewport(vk::CommandBuffer buffer, uv2 extent);
+    void retire();
 
     vk::UniquePipeline vk_pipeline_;
     vk::UniquePipelineLayout vk_layout_;
     vk::UniqueDescriptorSetLayout descriptor_layout_;
+    // Owned by the renderer
+    vk::DescriptorSetLayout frame_layout_;
 
-    bnr::subpass* subpass_;
+    bnr::subpass* subpass_{ nullptr };
+    // Set once created, destroys the vulkan objects after the frames using them
+    deletion_queue* deletions_{ nullptr };
 
     create_info info_;
     vector<vk::VertexInputBindingDescription> vertex_input_bindings_ = {};
     vector<vk::VertexInputAttributeDescription> vertex_input_attributes_ = {};
     vector<vk::PipelineColorBlendAttachmentState> color_blend_attachments_ = {};
     vector<vk::DynamicState> dynamic_states_ = {};
+    vector<vk::PushConstantRange> push_constants_ = {};
 
     shader_stages shader_stages_{};
 
@@ -0,0 +1,123 @@
+#include <algorithm>
+
+#include <banner/core/culling.hpp>
+#include <banner/entity/components.hpp>
+#include <banner/gfx/render_list.hpp>
+
+namespace bnr {
+render_list render_list::extract(
+    world* world, const transform_graph* graph, frame_arena& arena)
+{
+    render_list list;
+
+    query(world, [&](const transform&, const renderable&) { list.count++; });
+
+    // Nodes without a live graph node, e.g. freshly loaded ones, aren't drawn
+    if (graph) {
+        query(world, [&](const scene_node& n, const renderable&) {
+            list.count += graph->alive(n.id) ? 1 : 0;
+        });
+    }
+
+    if (list.empty())
+        return list;
+
+    struct draw
+    {
+        u64 key;
+        const transform* xform;
+        transform_graph::handle node;
+        const renderable* item;
+    };
+
+    // Sort small records first, then write the packed arrays in their final order
+    auto draws = arena.allocate<draw>(list.count);
+    u32 i{ 0 };
+
+    query(world, [&](const transform& t, const renderable& r) {
+        if (i < list.count) {
+            draws[i++] = { sort_key(r.material, r.mesh), &t, 0, &r };
+        }
+    });
+
+    if (graph) {
+        query(world, [&](const scene_node& n, const renderable& r) {
+            if (i < list.count && graph->alive(n.id)) {
+                draws[i++] = { sort_key(r.material, r.mesh), nullptr, n.id, &r };
+            }
+        });
+    }
+
+    std::sort(
+        draws, draws + i, [](const draw& a, const draw& b) { return a.key < b.key; });
+
+    list.count = i;
+    list.meshes = arena.allocate<u32>(list.count);
+    list.materials = arena.allocate<u32>(list.count);
+    list.transforms = arena.allocate<mat4>(list.count);
+    list.keys = arena.allocate<u64>(list.count);
+
+    for (i = 0; i < list.count; i++) {
+        list.meshes[i] = draws[i].item->mesh;
+        list.materials[i] = draws[i].item->material;
+        list.transforms[i] =
+            draws[i].xform ? draws[i].xform->matrix() : graph->world(draws[i].node);
+        list.keys[i] = draws[i].key;
+    }
+
+    return list;
+}
+
+void render_list::cull(
+    const frustum& view, const vector<aabb>& mesh_bounds, frame_arena& arena)
+{
+    if (empty())
+        return;
+
+    // Local bounds once per mesh, meshes without any are never culled
+    const auto shape_count = u32(mesh_bounds.size());
+    const auto shapes = arena.allocate<v4>(shape_count * 2);
+
+    for (u32 i = 0; i < shape_count; i++) {
+        const auto& box = mesh_bounds[i];
+        const auto valid = box.valid();
+
+        shapes[i * 2] = v4{ valid ? box.center() : v3{ 0.f }, 1.f };
+        shapes[i * 2 + 1] = v4{ valid ? box.extent() : v3{ culling::unbounded }, 0.f };
+    }
+
+    // Compacted a block at a time, while the block's matrices are still in cache
+    constexpr u32 block = 256;
+
+    u32 visible[block];
+    u32 kept{ 0 };
+
+    for (u32 begin = 0; begin < count; begin += block) {
+        const culling::placed_boxes boxes{ transforms + begin, meshes + begin, shapes,
+            shape_count };
+        const auto size = std::min(block, count - begin);
+        const auto hits = culling::cull(view, boxes, size, visible);
+
+        // Indices ascend, so compacting in place never overwrites an unread draw
+        for (u32 i = 0; i < hits; i++) {
+            const auto from = begin + visible[i];
+
+            meshes[kept] = meshes[from];
+            materials[kept] = materials[from];
+            transforms[kept] = transforms[from];
+            keys[kept] = keys[from];
+            kept++;
+        }
+    }
+
+    count = kept;
+}
+
+std::pair<u32, u32> render_list::range(u32 material) const
+{
+    const auto begin = std::lower_bound(keys, keys + count, sort_key(material, 0));
+    const auto end = std::lower_bound(begin, keys + count, sort_key(material + 1, 0));
+
+    return { u32(begin - keys), u32(end - keys) };
+}
+} // namespace bnr
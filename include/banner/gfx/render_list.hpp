@@ -0,0 +1,51 @@
+#pragma once
+
+#include <utility>
+
+#include <banner/core/geometry.hpp>
+#include <banner/core/math.hpp>
+#include <banner/core/transform_graph.hpp>
+#include <banner/core/types.hpp>
+#include <banner/entity/entity.hpp>
+#include <banner/util/frame_arena.hpp>
+
+namespace bnr {
+/**
+ * @brief Draws extracted from the world for one frame, packed as parallel arrays in
+ * a `frame_arena` and sorted by key. The arrays stay valid until the arena is reset.
+ */
+struct render_list
+{
+    u32 count{ 0 };
+
+    u32* meshes{ nullptr };
+    u32* materials{ nullptr };
+    mat4* transforms{ nullptr };
+    u64* keys{ nullptr };
+
+    /**
+     * @brief Draws sharing a material end up next to each other, then those sharing a
+     * mesh.
+     */
+    static u64 sort_key(u32 material, u32 mesh) { return u64(material) << 32 | mesh; }
+
+    /**
+     * @brief Gathers every entity with a `renderable` & either a `transform` or a
+     * `scene_node` of `graph`.
+     */
+    static render_list extract(
+        world* world, const transform_graph* graph, frame_arena& arena);
+
+    /**
+     * @brief Drops the draws whose mesh bounds are outside `view`, the order is kept.
+     */
+    void cull(const frustum& view, const vector<aabb>& mesh_bounds, frame_arena& arena);
+
+    /**
+     * @brief [begin, end) of the draws using `material`.
+     */
+    std::pair<u32, u32> range(u32 material) const;
+
+    bool empty() const { return count == 0; }
+};
+} // namespace bnr
@@ -1,6 +1,7 @@
 #include <algorithm>
 
 #include <banner/defs.hpp>
+#include <banner/gfx/deletion_queue.hpp>
 #include <banner/gfx/device.hpp>
 #include <banner/gfx/graphics.hpp>
 #include <banner/gfx/pipeline.hpp>
@@ -36,7 +37,9 @@ void render_pass::create()
     create_render_pass();
     create_framebuffers();
 
-    ctx()->swapchain()->on_recreate.connect<&render_pass::create_framebuffers>(*this);
+    auto& events = ctx()->swapchain()->events;
+    const auto added = events.on<"recreate", &render_pass::create_framebuffers>(*this);
+    ASSERT(added, "No free swapchain recreate slot for the render pass");
 
     for (auto& subpass : subpasses_) {
         subpass->create();
@@ -49,6 +52,11 @@ render_pass::~render_pass()
         sp.reset();
     }
     subpasses_.clear();
+
+    ctx()->swapchain()->events.off<"recreate", &render_pass::create_framebuffers>(*this);
+
+    retire_framebuffers();
+    ctx()->deletions()->push(std::move(vk_render_pass_));
 }
 
 
@@ -100,13 +108,12 @@ void render_pass::create_render_pass()
     std::transform(subpasses_.begin(), subpasses_.end(), std::back_inserter(subpasses),
         [&](uptr<bnr::subpass>& pass) { return pass->description(); });
 
-    if (vk_render_pass_) {
-        vk_render_pass_.release();
-    }
+    ctx()->deletions()->push(std::move(vk_render_pass_));
 
     vk_render_pass_ = device->createRenderPassUnique(
         { {}, u32(attachments_.size()), attachments_.data(), u32(subpasses.size()),
-            subpasses.data(), u32(dependencies_.size()), dependencies_.data() });
+            subpasses.data(), u32(dependencies_.size()), dependencies_.data() },
+        ctx()->device()->callbacks(vk::ObjectType::eRenderPass));
 
     ASSERT(vk_render_pass_, "Failed to create render pass!");
 }
@@ -116,15 +123,24 @@ void render_pass::create_framebuffers()
 
     extent_ = ctx()->swapchain()->extent();
 
-    framebuffers_.clear();
-    framebuffers_.resize(0);
+    // Frames in flight may still render to the old framebuffers
+    retire_framebuffers();
 
     for (auto& img_view : ctx()->swapchain()->data().views) {
         vector<vk::ImageView> framebuffer_attachments = { img_view.get() };
 
         framebuffers_.push_back(device->createFramebufferUnique(
             { {}, vk(), u32(framebuffer_attachments.size()),
-                framebuffer_attachments.data(), extent_.width, extent_.height, 1 }));
+                framebuffer_attachments.data(), extent_.width, extent_.height, 1 },
+            ctx()->device()->callbacks(vk::ObjectType::eFramebuffer)));
     }
 }
+
+void render_pass::retire_framebuffers()
+{
+    for (auto& framebuffer : framebuffers_) {
+        ctx()->deletions()->push(std::move(framebuffer));
+    }
+    framebuffers_.clear();
+}
 } // namespace bnr
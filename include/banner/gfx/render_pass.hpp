@@ -214,6 +214,7 @@ struct render_pass
 private:
     void create_render_pass();
     void create_framebuffers();
+    void retire_framebuffers();
 
     graphics* ctx_;
 
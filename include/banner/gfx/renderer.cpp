@@ -1,7 +1,24 @@
+#include <thread>
+
 #include <banner/gfx/renderer.hpp>
 #include <banner/gfx/vk_utils.hpp>
 
 namespace bnr {
+namespace {
+// Weight of the newest sample in the smoothed frame times
+constexpr f64 smoothing = 0.1;
+
+f64 smooth(f64 average, f64 sample)
+{
+    return average == 0.0 ? sample : average + (sample - average) * smoothing;
+}
+
+f64 micros(duration d)
+{
+    return std::chrono::duration<f64, std::micro>(d).count();
+}
+} // namespace
+
 renderer::task::task(bnr::device* device, task::fn fn, vk::CommandPool pool, u32 count)
     : process{ fn }
 {
@@ -16,23 +33,76 @@ void renderer::task::free(bnr::device* device, vk::CommandPool pool)
     device->vk().freeCommandBuffers(pool, cmd_buffers);
 }
 
-renderer::renderer(graphics* ctx)
+renderer::renderer(graphics* ctx, bnr::jobs* jobs, options opts)
     : ctx_{ ctx }
+    , jobs_{ jobs }
+    , opts_{ opts }
 
 {
     // Create command pool
     cmd_pool = (device()->vk().createCommandPool(
         { vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
-            device()->queue().present_index }));
+            device()->queue().present_index },
+        device()->callbacks(vk::ObjectType::eCommandPool)));
 
     // Create sync objects
+    const auto fence_callbacks = device()->callbacks(vk::ObjectType::eFence);
+
     for (u32 i = 0; i < swapchain()->image_count(); i++) {
         vk::FenceCreateInfo info = { vk::FenceCreateFlagBits::eSignaled };
-        flight_fences_.push_back(device()->vk().createFence(info));
+        flight_fences_.push_back(device()->vk().createFence(info, fence_callbacks));
+    }
+
+    fence_frames_.resize(flight_fences_.size(), 0);
+
+    const auto semaphore_callbacks = device()->callbacks(vk::ObjectType::eSemaphore);
+    sync_.aquire = device()->vk().createSemaphoreUnique({}, semaphore_callbacks);
+    sync_.render = device()->vk().createSemaphoreUnique({}, semaphore_callbacks);
+
+    create_frame_set();
+}
+
+vk::DescriptorSetLayoutBinding renderer::frame_binding()
+{
+    return { 0, vk::DescriptorType::eUniformBufferDynamic, 1,
+        vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment };
+}
+
+void renderer::create_frame_set()
+{
+    // One region per swapchain image, never more frames than that in flight
+    frame_data_ = make_uptr<dynamic_buffer>(ctx_, u32(sizeof(frame_constants)),
+        swapchain()->image_count(), vk::BufferUsageFlagBits::eUniformBuffer);
+
+    const auto binding = frame_binding();
+    frame_layout_ = device()->vk().createDescriptorSetLayoutUnique({ {}, 1, &binding },
+        device()->callbacks(vk::ObjectType::eDescriptorSetLayout));
+
+    const vk::DescriptorPoolSize size{ vk::DescriptorType::eUniformBufferDynamic, 1 };
+    descriptor_pool_ = device()->vk().createDescriptorPoolUnique(
+        { {}, 1, 1, &size }, device()->callbacks(vk::ObjectType::eDescriptorPool));
+
+    frame_set_ = device()->vk().allocateDescriptorSets(
+        { descriptor_pool_.get(), 1, &frame_layout_.get() })[0];
+
+    // The buffer never changes, only the dynamic offset does
+    const auto info = frame_data_->descriptor(u32(sizeof(frame_constants)));
+    const vk::WriteDescriptorSet write{ frame_set_, 0, 0, 1,
+        vk::DescriptorType::eUniformBufferDynamic, nullptr, &info };
+
+    device()->vk().updateDescriptorSets(write, nullptr);
+}
+
+void renderer::write_constants()
+{
+    frame_data_->begin_frame();
+
+    const auto offset = frame_data_->push(constants_);
+    if (offset != dynamic_buffer::invalid) {
+        frame_offset_ = offset;
     }
 
-    sync_.aquire = device()->vk().createSemaphoreUnique({});
-    sync_.render = device()->vk().createSemaphoreUnique({});
+    frame_data_->flush();
 }
 
 auto renderer::wait() const
@@ -52,28 +122,134 @@ auto renderer::reset_fence(u32 idx) const
 
 renderer::~renderer()
 {
-    wait();
+    // Frames in flight still use the pools & fences, nothing retires them after this
+    // so they go when graphics flushes the queue
+    vector<vk::CommandPool> pools{ cmd_pool };
 
     for (auto& task : tasks_) {
-        task->free(device(), cmd_pool);
+        if (task->pool) {
+            pools.push_back(task->pool);
+        }
         delete task;
     }
 
-    device()->vk().destroyCommandPool(cmd_pool);
+    // Destroying a pool frees its command buffers
+    ctx()->deletions()->push([device = device(), pools, fences = flight_fences_]() {
+        for (auto pool : pools) {
+            device->vk().destroyCommandPool(
+                pool, device->callbacks(vk::ObjectType::eCommandPool));
+        }
 
-    for (u32 i{ 0 }; i < flight_fences_.size(); i++) {
-        device()->vk().destroyFence(flight_fences_[i]);
-    }
+        for (auto fence : fences) {
+            device->vk().destroyFence(fence, device->callbacks(vk::ObjectType::eFence));
+        }
+    });
+
+    ctx()->deletions()->push(std::move(descriptor_pool_));
+    ctx()->deletions()->push(std::move(frame_layout_));
+    frame_data_.reset();
+
+    ctx()->deletions()->push(std::move(sync_.aquire));
+    ctx()->deletions()->push(std::move(sync_.render));
 
     flight_fences_.clear();
     tasks_.clear();
 }
 
-void renderer::add_task(task::fn task)
+void renderer::add_task(task::fn task, bool parallel)
 {
+    vk::CommandPool pool{ nullptr };
+
+    // Command pools can't be used from several threads at once
+    if (parallel) {
+        pool = device()->vk().createCommandPool(
+            { vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
+                device()->queue().present_index },
+            device()->callbacks(vk::ObjectType::eCommandPool));
+    }
+
     // Create task
-    tasks_.push_back(
-        new renderer::task(device(), task, cmd_pool, swapchain()->image_count()));
+    tasks_.push_back(new renderer::task(
+        device(), task, pool ? pool : cmd_pool, swapchain()->image_count()));
+    tasks_.back()->pool = pool;
+}
+
+u32 renderer::add_mesh(sptr<mesh_primitive> mesh)
+{
+    mesh_bounds_.push_back(mesh->bounds());
+    meshes_.push_back(std::move(mesh));
+    return u32(meshes_.size() - 1);
+}
+
+u32 renderer::add_material(pipeline* pipeline)
+{
+    const auto id = u32(materials_.size());
+
+    materials_.push_back(pipeline);
+    pipeline->set_frame_layout(frame_layout_.get());
+    pipeline->on_process = [this, id](vk::CommandBuffer cmd) { draw(cmd, id); };
+
+    return id;
+}
+
+void renderer::extract(world* world, const transform_graph* graph)
+{
+    arena_.reset();
+    list_ = render_list::extract(world, graph, arena_);
+
+    if (view_) {
+        list_.cull(*view_, mesh_bounds_, arena_);
+    }
+}
+
+void renderer::pace()
+{
+    if (!opts_.pace || frame_ <= opts_.queued_frames) {
+        frame_start_ = clock::now();
+        return;
+    }
+
+    const auto target = frame_ - opts_.queued_frames;
+
+    if (completed_ < target) {
+        // The gpu finishes a frame about every gpu_us_, start recording just in time
+        const auto predicted = completion_time_ +
+            std::chrono::duration_cast<duration>(std::chrono::duration<f64, std::micro>(
+                gpu_us_ * f64(target - completed_) - cpu_us_ - micros(opts_.margin)));
+
+        if (predicted > clock::now()) {
+            std::this_thread::sleep_until(predicted);
+        }
+
+        // Fences signal in submission order, any fence of a frame >= target will do
+        u32 index{ ~0u };
+        for (u32 i = 0; i < fence_frames_.size(); i++) {
+            if (fence_frames_[i] >= target &&
+                (index == ~0u || fence_frames_[i] < fence_frames_[index])) {
+                index = i;
+            }
+        }
+
+        const auto before = clock::now();
+
+        if (index != ~0u && vk_utils::success(wait(index))) {
+            const auto now = clock::now();
+            const auto done = fence_frames_[index];
+
+            // Only a blocking wait tells when the gpu finished, otherwise it was earlier
+            const bool blocked = now - before > us(50);
+
+            if (blocked && done > completed_) {
+                gpu_us_ = smooth(
+                    gpu_us_, micros(now - completion_time_) / f64(done - completed_));
+            }
+
+            completed_ = std::max(completed_, done);
+            completion_time_ = blocked ? now : before;
+        }
+    }
+
+    frame_start_ = clock::now();
 }
 
 void renderer::render()
@@ -84,6 +260,7 @@ void renderer::render()
     if (!aquire_next_image())
         return;
 
+    write_constants();
     process_tasks();
     end_frame();
 }
@@ -93,6 +270,10 @@ bool renderer::aquire_next_image()
     if (!vk_utils::success(wait(current_)))
         return false;
 
+    // A signaled fence implies all earlier submissions have completed
+    completed_ = std::max(completed_, fence_frames_[current_]);
+    ctx()->deletions()->retire(completed_);
+
     auto aquire_result = swapchain()->aquire_image(sync_.aquire.get());
 
     if (aquire_result.result == vk::Result::eErrorOutOfDateKHR) {
@@ -103,6 +284,8 @@ bool renderer::aquire_next_image()
     }
 
     current_ = aquire_result.value;
+    frame_++;
+    ctx()->deletions()->set_frame(frame_);
 
     reset_fence(current_index());
 
@@ -113,18 +296,70 @@ void renderer::process_tasks()
 {
     device()->vk().resetCommandPool(cmd_pool, (vk::CommandPoolResetFlagBits)0);
 
+    parallel_tasks_.clear();
+
     for (auto& task : tasks_) {
-        auto& [proc, buffs] = *task;
+        if (task->pool) {
+            device()->vk().resetCommandPool(task->pool, (vk::CommandPoolResetFlagBits)0);
+            parallel_tasks_.push_back(task);
+        } else {
+            record(task);
+        }
+    }
+
+    if (!jobs_) {
+        std::for_each(parallel_tasks_.begin(), parallel_tasks_.end(),
+            [&](task* task) { record(task); });
+        return;
+    }
+
+    jobs_->parallel_for(u32(parallel_tasks_.size()), 1, [&](u32 begin, u32 end) {
+        for (auto i = begin; i < end; i++) {
+            record(parallel_tasks_[i]);
+        }
+    });
+}
+
+void renderer::record(task* task)
+{
+    auto cmd_buff = task->cmd_buffers[current_];
 
-        auto cmd_buff = buffs[current_];
+    cmd_buff.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
 
-        cmd_buff.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    if (task->process) {
+        task->process(cmd_buff);
+    }
+
+    cmd_buff.end();
+}
 
-        if (proc) {
-            proc(cmd_buff);
+void renderer::draw(vk::CommandBuffer cmd, u32 material) const
+{
+    const auto [begin, end] = list_.range(material);
+    const auto pipeline = materials_[material];
+
+    if (begin < end) {
+        cmd.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipeline->layout(), 0,
+            frame_set_, frame_offset_);
+    }
+
+    const auto& ranges = pipeline->push_constants();
+    const bool push = !ranges.empty() &&
+        (ranges.front().stageFlags & vk::ShaderStageFlagBits::eVertex) &&
+        ranges.front().size >= sizeof(mat4);
+
+    for (auto i = begin; i < end; i++) {
+        const auto mesh = list_.meshes[i];
+
+        if (mesh >= meshes_.size())
+            continue;
+
+        if (push) {
+            cmd.pushConstants(pipeline->layout(), ranges.front().stageFlags, 0,
+                sizeof(mat4), &list_.transforms[i]);
         }
 
-        cmd_buff.end();
+        meshes_[mesh]->draw(cmd);
     }
 }
 
@@ -144,6 +379,9 @@ void renderer::end_frame()
     submit_info.setPSignalSemaphores(&sync_.render.get());
 
     device()->queue().submit(submit_info, flight_fences_[current_]);
+    fence_frames_[current_] = frame_;
+
+    cpu_us_ = smooth(cpu_us_, micros(clock::now() - frame_start_));
 
     // Present stage
     vk::PresentInfoKHR present_info;
@@ -1,11 +1,19 @@
 #pragma once
 
 #include <algorithm>
+#include <optional>
 
+#include <banner/core/jobs.hpp>
 #include <banner/core/types.hpp>
 #include <banner/gfx/device.hpp>
 #include <banner/gfx/graphics.hpp>
+#include <banner/gfx/pipeline.hpp>
+#include <banner/gfx/render_list.hpp>
+#include <banner/gfx/res/dynamic_buffer.hpp>
+#include <banner/gfx/res/mesh.hpp>
 #include <banner/gfx/swapchain.hpp>
+#include <banner/util/frame_arena.hpp>
+#include <banner/util/time.hpp>
 #include <vulkan/vulkan.hpp>
 
 namespace bnr {
@@ -23,6 +31,9 @@ struct renderer
         task::fn process;
         cmd_buffers cmd_buffers;
 
+        // Parallel tasks record from their own pool
+        vk::CommandPool pool{ nullptr };
+
         task(device*, task::fn, vk::CommandPool, u32);
         void free(device*, vk::CommandPool);
     };
@@ -33,10 +44,74 @@ struct renderer
         vk::UniqueSemaphore render{ nullptr };
     };
 
-    explicit renderer(graphics* ctx);
+    /**
+     * @brief Frame pacing, see `pace`.
+     */
+    struct options
+    {
+        bool pace{ false };
+        // Frames still allowed on the gpu when a paced frame starts
+        u32 queued_frames{ 0 };
+        // Slack for the cpu when starting just in time
+        us margin{ 1000 };
+    };
+
+    /**
+     * @brief Written to a dynamic uniform buffer once per frame, bound at set 0 binding
+     * 0 of every material.
+     */
+    struct frame_constants
+    {
+        mat4 view_projection{ 1.f };
+    };
+
+    renderer(graphics* ctx, bnr::jobs* jobs, options opts);
     ~renderer();
 
-    void add_task(task::fn task);
+    /**
+     * @brief Tasks are recorded in insertion order on the render thread, `parallel`
+     * tasks are recorded as jobs after the others and must not depend on their side
+     * effects. Submission order is always the insertion order.
+     */
+    void add_task(task::fn task, bool parallel = false);
+
+    /**
+     * @brief Registers a mesh for `renderable::mesh`.
+     */
+    u32 add_mesh(sptr<mesh_primitive> mesh);
+
+    /**
+     * @brief Registers a pipeline for `renderable::material`, the pipeline then draws
+     * its share of the render list. A vertex push constant of at least a `mat4`
+     * receives the transform of every draw, `frame_constants` are bound at set 0.
+     */
+    u32 add_material(pipeline* pipeline);
+
+    /**
+     * @brief Replaces the render list with the renderables of `world`, called once
+     * per frame after the simulation has stepped.
+     */
+    void extract(world* world, const transform_graph* graph = nullptr);
+
+    /**
+     * @brief Culls extracted draws against the frustum of `view_projection`.
+     */
+    void set_view(const mat4& view_projection)
+    {
+        view_ = frustum::from(view_projection);
+        constants_.view_projection = view_projection;
+    }
+
+    void clear_view()
+    {
+        view_.reset();
+        constants_.view_projection = mat4{ 1.f };
+    }
+
+    static vk::DescriptorSetLayoutBinding frame_binding();
+
+    const auto& list() const { return list_; }
+    auto& arena() { return arena_; }
 
     auto ctx() const { return ctx_; }
     auto device() const { return ctx_->device(); }
@@ -44,6 +119,13 @@ struct renderer
 
     u32 current_index() const { return current_; };
 
+    /**
+     * @brief Number of the frame currently being recorded & the last frame the gpu is
+     * known to have finished.
+     */
+    u64 frame() const { return frame_; }
+    u64 completed_frame() const { return completed_; }
+
     auto current_buffers()
     {
         vector<vk::CommandBuffer> v{};
@@ -55,6 +137,23 @@ struct renderer
     auto& sync() const { return sync_; }
     auto& pool() { return cmd_pool; }
 
+    /**
+     * @brief Delays the start of the next cpu frame so the cpu stays only
+     * `queued_frames` ahead of the gpu. Sleeps until the gpu is predicted to finish
+     * minus the measured cpu frame time & `margin`, then waits for the fence. Called
+     * before input is sampled so the frame starts with the freshest input.
+     */
+    void pace();
+
+    auto& opts() { return opts_; }
+
+    /**
+     * @brief Smoothed gpu time per frame as measured by `pace` & cpu time from the
+     * start of a frame to its submit.
+     */
+    f64 gpu_frame_us() const { return gpu_us_; }
+    f64 cpu_frame_us() const { return cpu_us_; }
+
     void render();
     auto wait() const;
     auto wait(u32 idx) const;
@@ -63,16 +162,46 @@ struct renderer
 private:
     bool aquire_next_image();
     void process_tasks();
+    void record(task* task);
+    void draw(vk::CommandBuffer cmd, u32 material) const;
+    void create_frame_set();
+    void write_constants();
     void end_frame();
 
     graphics* ctx_{ nullptr };
+    bnr::jobs* jobs_{ nullptr };
+    options opts_;
 
     task::list tasks_;
+    task::list parallel_tasks_;
     vk::CommandPool cmd_pool;
 
+    vector<sptr<mesh_primitive>> meshes_;
+    vector<aabb> mesh_bounds_;
+    vector<pipeline*> materials_;
+
+    frame_arena arena_;
+    render_list list_;
+    std::optional<frustum> view_;
+
+    frame_constants constants_;
+    uptr<dynamic_buffer> frame_data_;
+    vk::UniqueDescriptorSetLayout frame_layout_;
+    vk::UniqueDescriptorPool descriptor_pool_;
+    vk::DescriptorSet frame_set_;
+    u32 frame_offset_{ 0 };
+
     fences flight_fences_;
+    vector<u64> fence_frames_;
     synchronization sync_;
 
     u32 current_{ 0 };
+    u64 frame_{ 0 };
+    u64 completed_{ 0 };
+
+    time_point frame_start_{ clock::now() };
+    time_point completion_time_{ clock::now() };
+    f64 gpu_us_{ 0.0 };
+    f64 cpu_us_{ 0.0 };
 };
 } // namespace bnr
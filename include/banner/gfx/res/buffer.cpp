@@ -1,84 +1,52 @@
 #include <banner/gfx/graphics.hpp>
 #include <banner/gfx/res/buffer.hpp>
 #include <banner/gfx/vk_utils.hpp>
+#include <banner/util/debug.hpp>
 
 namespace bnr {
-using vk_utils::success;
-
 buffer::buffer(graphics* ctx, const void* data, u32 size, vk::BufferUsageFlagBits usage,
     bool gpu_only)
     : ctx_{ ctx }
 {
-    auto allocator = ctx->memory()->allocator();
+    auto memory = ctx->memory();
     auto mem_usage = gpu_only ? VMA_MEMORY_USAGE_GPU_ONLY : VMA_MEMORY_USAGE_CPU_ONLY;
 
-    auto [buffer, alloc] = buffer::allocate_vk_buffer(ctx, data, size,
-        (usage | vk::BufferUsageFlagBits::eTransferDst), gpu_only, mem_usage);
+    pool_ = memory->pool(usage | vk::BufferUsageFlagBits::eTransferDst, mem_usage);
+    slice_ = pool_->allocate(size);
 
-    vk_buffer_ = buffer;
-    allocation_ = alloc;
+    if (!slice_.valid()) {
+        debug::err("Failed to allocate buffer of size %u", size);
+        return;
+    }
 
-    if (data && gpu_only) {
+    if (data && slice_.mapped) {
+        memcpy(slice_.mapped, data, size);
+    } else if (data) {
+        auto staging_pool = memory->pool(
+            vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY);
+        auto staging = staging_pool->allocate(size);
+
+        if (!staging.valid()) {
+            debug::err("Failed to allocate staging buffer of size %u", size);
+            pool_->free(slice_);
+            return;
+        }
 
-        auto [staging_buffer, staging_alloc] = buffer::allocate_vk_buffer(ctx, data, size,
-            (usage | vk::BufferUsageFlagBits::eTransferSrc), false,
-            VMA_MEMORY_USAGE_CPU_ONLY);
+        memcpy(staging.mapped, data, size);
 
         ctx_->command([&](vk::CommandBuffer buff) {
-            vk::BufferCopy region{ 0u, 0u, size };
-            buff.copyBuffer(staging_buffer, vk_buffer_, region);
+            vk::BufferCopy region{ staging.offset, slice_.offset, size };
+            buff.copyBuffer(staging.buffer, slice_.buffer, region);
         });
 
-        vmaDestroyBuffer(allocator, staging_buffer, staging_alloc);
+        staging_pool->free(staging);
     }
 
-    descriptor_.buffer = vk_buffer_;
-    descriptor_.offset = 0;
-    descriptor_.range = size;
+    pool_->bind(slice_);
 }
 
 buffer::~buffer()
 {
-    vmaDestroyBuffer(ctx()->memory()->allocator(), vk_buffer_, allocation_);
+    pool_->free(slice_, ctx_->deletions());
 }
-
-std::tuple<vk::Buffer, VmaAllocation> buffer::allocate_vk_buffer(graphics* ctx,
-    const void* data, u32 size, vk::BufferUsageFlags usage, bool mapped,
-    VmaMemoryUsage memory_usage)
-{
-    vk::Buffer buffer;
-    VmaAllocation allocation;
-
-    auto allocator = ctx->memory()->allocator();
-
-    VmaAllocationCreateInfo allocation_create_info{
-        .flags{ VMA_ALLOCATION_CREATE_MAPPED_BIT },
-        .usage{ memory_usage },
-    };
-
-    vk::BufferCreateInfo buffer_create_info{ {}, size, usage,
-        vk::SharingMode::eExclusive };
-
-
-    if (!success(vmaCreateBuffer(allocator,
-            reinterpret_cast<VkBufferCreateInfo*>(&buffer_create_info),
-            &allocation_create_info, reinterpret_cast<VkBuffer*>(&buffer), &allocation,
-            nullptr))) {
-        debug::fatal("Failed to create staging buffer!");
-    }
-
-    if (data && !mapped) {
-        void* tmp{};
-        if (!success(vmaMapMemory(allocator, allocation, &tmp))) {
-            debug::fatal("Failed to map staging buffer!");
-        }
-
-        memcpy(tmp, data, u32(size));
-        vmaUnmapMemory(allocator, allocation);
-    }
-
-    return std::make_tuple(buffer, allocation);
-}
-
-
-} // namespace bnr
\ No newline at end of file
+} // namespace bnr
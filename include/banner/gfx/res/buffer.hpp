@@ -1,8 +1,7 @@
 #pragma once
 
-#include <tuple>
-
 #include <banner/core/types.hpp>
+#include <banner/gfx/buffer_pool.hpp>
 #include <banner/gfx/memory.hpp>
 #include <banner/gfx/res/resource.hpp>
 #include <vulkan/vulkan.hpp>
@@ -10,33 +9,41 @@
 namespace bnr {
 struct graphics;
 
+/**
+ * @brief Pool slice registered with the defragmenter by address, so buffers can't be
+ * copied or moved, hold them through a pointer.
+ */
 struct buffer : resource
 {
-    using list = vector<buffer>;
-
     explicit buffer(graphics* ctx, const void* data, u32 size,
         vk::BufferUsageFlagBits usage = vk::BufferUsageFlagBits::eVertexBuffer,
         bool gpu_only = true);
 
     ~buffer();
 
-    auto vk() const { return vk_buffer_; }
+    buffer(const buffer&) = delete;
+    buffer& operator=(const buffer&) = delete;
+
+    auto vk() const { return slice_.buffer; }
     auto ctx() { return ctx_; }
 
-    auto valid() const { return (bool)vk_buffer_; }
-    auto size() const { return descriptor_.range; }
+    auto valid() const { return slice_.valid(); }
+    auto size() const { return slice_.size; }
+    auto offset() const { return slice_.offset; }
 
-private:
-    static std::tuple<vk::Buffer, VmaAllocation> buffer::allocate_vk_buffer(graphics* ctx,
-        const void* data, u32 size, vk::BufferUsageFlags usage, bool mapped,
-        VmaMemoryUsage memory_usage);
+    /**
+     * @brief Slices may be relocated by the defragmenter, so descriptors should be
+     * re-queried rather than cached.
+     */
+    vk::DescriptorBufferInfo descriptor() const
+    {
+        return { slice_.buffer, slice_.offset, slice_.size };
+    }
 
+private:
     graphics* ctx_;
+    buffer_pool* pool_;
 
-    vk::Buffer vk_buffer_;
-    vk::DescriptorBufferInfo descriptor_;
-
-    VmaAllocation allocation_;
-    VmaAllocationInfo allocation_info_;
+    buffer_pool::slice slice_;
 };
-} // namespace bnr
\ No newline at end of file
+} // namespace bnr
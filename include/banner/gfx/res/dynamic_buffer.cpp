@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include <banner/gfx/graphics.hpp>
+#include <banner/gfx/res/dynamic_buffer.hpp>
+#include <banner/gfx/vk_utils.hpp>
+
+namespace bnr {
+using vk_utils::success;
+
+namespace {
+inline u32 align_up(u32 value, u32 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+dynamic_buffer::dynamic_buffer(
+    graphics* ctx, u32 frame_size, u32 frames, vk::BufferUsageFlagBits usage)
+    : ctx_{ ctx }
+    , frames_{ frames }
+{
+    const auto& limits = ctx->device()->limits();
+
+    alignment_ = u32(std::max(
+        { limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment,
+            limits.nonCoherentAtomSize, vk::DeviceSize(16) }));
+
+    frame_size_ = align_up(frame_size, alignment_);
+
+    // Host visible is required, device local (BAR/ReBAR) is preferred
+    VmaAllocationCreateInfo allocation_create_info{
+        .flags{ VMA_ALLOCATION_CREATE_MAPPED_BIT },
+        .usage{ VMA_MEMORY_USAGE_CPU_TO_GPU },
+        .requiredFlags{ VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT },
+        .preferredFlags{ VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+            VK_MEMORY_PROPERTY_HOST_COHERENT_BIT },
+    };
+
+    vk::BufferCreateInfo buffer_create_info{ {}, vk::DeviceSize(frame_size_) * frames_,
+        usage, vk::SharingMode::eExclusive };
+
+    VmaAllocationInfo allocation_info{};
+
+    if (!success(vmaCreateBuffer(ctx->memory()->allocator(),
+            reinterpret_cast<VkBufferCreateInfo*>(&buffer_create_info),
+            &allocation_create_info, reinterpret_cast<VkBuffer*>(&vk_buffer_),
+            &allocation_, &allocation_info))) {
+        debug::fatal("Failed to create dynamic buffer!");
+    }
+
+    mapped_ = static_cast<uc8*>(allocation_info.pMappedData);
+
+    VkMemoryPropertyFlags flags{};
+    vmaGetMemoryTypeProperties(
+        ctx->memory()->allocator(), allocation_info.memoryType, &flags);
+
+    device_local_ = flags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    coherent_ = flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    ctx->memory()->track(memory::category::uniform, buffer_create_info.size);
+}
+
+dynamic_buffer::~dynamic_buffer()
+{
+    // Earlier frame regions may still be read by the gpu
+    ctx()->deletions()->push([mem = ctx()->memory(), buffer = vk_buffer_,
+                                 allocation = allocation_,
+                                 size = vk::DeviceSize(frame_size_) * frames_]() {
+        mem->untrack(memory::category::uniform, size);
+        vmaDestroyBuffer(mem->allocator(), buffer, allocation);
+    });
+}
+
+void dynamic_buffer::begin_frame()
+{
+    frame_ = (frame_ + 1) % frames_;
+    head_ = 0;
+}
+
+u32 dynamic_buffer::push(const void* data, u32 size)
+{
+    const auto aligned = align_up(size, alignment_);
+
+    if (head_ + aligned > frame_size_) {
+        debug::err("Dynamic buffer frame region overflow (%u bytes)", frame_size_);
+        return invalid;
+    }
+
+    const auto offset = frame_ * frame_size_ + head_;
+    memcpy(mapped_ + offset, data, size);
+    head_ += aligned;
+
+    return offset;
+}
+
+void dynamic_buffer::flush()
+{
+    if (coherent_ || head_ == 0)
+        return;
+
+    vmaFlushAllocation(
+        ctx()->memory()->allocator(), allocation_, frame_ * frame_size_, head_);
+}
+} // namespace bnr
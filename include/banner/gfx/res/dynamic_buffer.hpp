@@ -0,0 +1,85 @@
+#pragma once
+
+#include <banner/core/types.hpp>
+#include <banner/gfx/memory.hpp>
+#include <banner/gfx/res/resource.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct graphics;
+
+/**
+ * @brief Persistently mapped buffer split into one region per frame in flight. Data
+ * is written straight into the mapped region and bound through dynamic offsets
+ * (`eUniformBufferDynamic` / `eStorageBufferDynamic`).
+ *
+ * Prefers host visible, device local memory (BAR/ReBAR) and falls back to host
+ * visible system memory.
+ */
+struct dynamic_buffer : resource
+{
+    static constexpr u32 invalid = ~0u;
+
+    explicit dynamic_buffer(graphics* ctx, u32 frame_size, u32 frames,
+        vk::BufferUsageFlagBits usage = vk::BufferUsageFlagBits::eUniformBuffer);
+
+    ~dynamic_buffer();
+
+    /**
+     * @brief Advances to the next frame region and resets its write head.
+     */
+    void begin_frame();
+
+    /**
+     * @brief Copies data into the current frame region, returns the dynamic offset or
+     * `invalid` when the region is full.
+     */
+    u32 push(const void* data, u32 size);
+
+    template<typename T>
+    u32 push(const T& value)
+    {
+        return push(&value, u32(sizeof(T)));
+    }
+
+    /**
+     * @brief Flushes the written range of the current frame, no-op on coherent memory.
+     */
+    void flush();
+
+    auto vk() const { return vk_buffer_; }
+    auto ctx() { return ctx_; }
+
+    auto frame() const { return frame_; }
+    auto frame_size() const { return frame_size_; }
+    auto alignment() const { return alignment_; }
+
+    auto device_local() const { return device_local_; }
+    auto coherent() const { return coherent_; }
+
+    /**
+     * @brief Descriptor for a dynamic binding, `range` is the size of one element.
+     */
+    vk::DescriptorBufferInfo descriptor(u32 range) const
+    {
+        return { vk_buffer_, 0, range };
+    }
+
+private:
+    graphics* ctx_;
+
+    vk::Buffer vk_buffer_;
+    VmaAllocation allocation_{ nullptr };
+    uc8* mapped_{ nullptr };
+
+    u32 frames_;
+    u32 frame_size_;
+    u32 alignment_;
+
+    u32 frame_{ 0 };
+    u32 head_{ 0 };
+
+    bool device_local_{ false };
+    bool coherent_{ false };
+};
+} // namespace bnr
@@ -1,32 +1,72 @@
 #include <banner/gfx/graphics.hpp>
 #include <banner/gfx/res/mesh.hpp>
+#include <banner/gfx/res/mesh_optimizer.hpp>
 
 namespace bnr {
 mesh_primitive::mesh_primitive(graphics* ctx, type mesh_type)
+    : mesh_primitive{ ctx, mesh_primitive::make_mesh_data(mesh_type) }
+{
+    type_ = mesh_type;
+}
+
+mesh_primitive::mesh_primitive(graphics* ctx, data mesh_data, bool optimize)
     : ctx_{ ctx }
-    , type_{ mesh_type }
-    , data_{ mesh_primitive::make_mesh_data(type_) }
+    , type_{ type::custom }
+    , data_{ std::move(mesh_data) }
+{
+    if (optimize) {
+        mesh_utils::optimize(data_);
+    }
 
+    create_buffers();
+}
+
+void mesh_primitive::create_buffers()
 {
     if (data_.has_vertices()) {
         buffer_vertices_ = std::make_unique<buffer>(ctx_, data_.vertices.data(),
             data_.vertices_size(), vk::BufferUsageFlagBits::eVertexBuffer);
     }
-    if (data_.has_indices()) {
+
+    if (!data_.has_indices())
+        return;
+
+    // Narrow to 16-bit indices when every vertex is addressable
+    if (mesh_utils::fits_u16(data_)) {
+        vector<u16> narrow(data_.indices.begin(), data_.indices.end());
+        index_type_ = vk::IndexType::eUint16;
+        buffer_indices_ = std::make_unique<buffer>(ctx_, narrow.data(),
+            u32(narrow.size() * sizeof(u16)), vk::BufferUsageFlagBits::eIndexBuffer);
+    } else {
+        index_type_ = vk::IndexType::eUint32;
         buffer_indices_ = std::make_unique<buffer>(ctx_, data_.indices.data(),
             data_.indices_size(), vk::BufferUsageFlagBits::eIndexBuffer);
     }
 }
 
+aabb mesh_primitive::bounds() const
+{
+    aabb box;
+    for (const auto& v : data_.vertices) {
+        box = aabb::merge(box, { v3{ v.pos, 0.f }, v3{ v.pos, 0.f } });
+    }
+    return box;
+}
+
 void mesh_primitive::draw(vk::CommandBuffer buffer) const
 {
+    // Buffers that failed to allocate leave nothing to draw from
+    if ((buffer_vertices_ && !buffer_vertices_->valid()) ||
+        (buffer_indices_ && !buffer_indices_->valid()))
+        return;
+
     if (buffer_vertices_ && buffer_vertices_->valid()) {
-        buffer.bindVertexBuffers(0, buffer_vertices_->vk(), vk::DeviceSize(0));
+        buffer.bindVertexBuffers(0, buffer_vertices_->vk(), buffer_vertices_->offset());
     }
 
     if (buffer_indices_ && buffer_indices_->valid()) {
         buffer.bindIndexBuffer(
-            buffer_indices_->vk(), vk::DeviceSize(0), vk::IndexType::eUint32);
+            buffer_indices_->vk(), buffer_indices_->offset(), index_type_);
     }
 
     if (data_.has_indices()) {
@@ -70,4 +110,9 @@ sptr<mesh_primitive> make_quad(graphics* ctx)
 {
     return std::make_shared<mesh_primitive>(ctx, mesh_primitive::type::quad);
 }
+
+sptr<mesh_primitive> make_mesh(graphics* ctx, mesh_primitive::data data)
+{
+    return std::make_shared<mesh_primitive>(ctx, std::move(data));
+}
 } // namespace bnr
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <array>
 
+#include <banner/core/geometry.hpp>
 #include <banner/core/types.hpp>
 #include <banner/gfx/res/buffer.hpp>
 #include <banner/gfx/res/resource.hpp>
@@ -40,10 +41,12 @@ struct mesh_primitive : resource
     {
         triangle,
         cube,
-        quad
+        quad,
+        custom
     };
 
     explicit mesh_primitive(graphics* ctx, type mesh_type);
+    explicit mesh_primitive(graphics* ctx, data mesh_data, bool optimize = true);
 
     virtual ~mesh_primitive() = default;
 
@@ -53,14 +56,24 @@ struct mesh_primitive : resource
 
     auto empty() const { return data_.vertices.empty(); }
 
+    auto index_type() const { return index_type_; }
+
+    /**
+     * @brief Bounds of the vertex positions.
+     */
+    aabb bounds() const;
+
     void draw(vk::CommandBuffer buf) const;
 
 private:
     static data make_mesh_data(type type);
 
+    void create_buffers();
+
     graphics* ctx_;
     type type_;
     data data_;
+    vk::IndexType index_type_{ vk::IndexType::eUint32 };
 
     uptr<buffer> buffer_vertices_;
     uptr<buffer> buffer_indices_;
@@ -69,4 +82,6 @@ private:
 sptr<mesh_primitive> make_triangle(graphics* ctx);
 
 sptr<mesh_primitive> make_quad(graphics* ctx);
+
+sptr<mesh_primitive> make_mesh(graphics* ctx, mesh_primitive::data data);
 } // namespace bnr
\ No newline at end of file
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <glm/geometric.hpp>
+
+#include <banner/gfx/res/mesh_optimizer.hpp>
+
+namespace bnr {
+namespace mesh_utils {
+namespace {
+constexpr u32 cache_size = 32;
+constexpr u32 cache_sim_size = 16;
+constexpr u32 invalid = ~0u;
+
+// https://tomforsyth1000.github.io/papers/fast_vert_cache_opt.html
+f32 vertex_score(i32 cache_pos, u32 remaining)
+{
+    if (remaining == 0)
+        return -1.f;
+
+    f32 score = 0.f;
+
+    if (cache_pos >= 0) {
+        if (cache_pos < 3) {
+            score = 0.75f;
+        } else {
+            score = std::pow(1.f - f32(cache_pos - 3) / f32(cache_size - 3), 1.5f);
+        }
+    }
+
+    return score + 2.f * std::pow(f32(remaining), -0.5f);
+}
+
+// Simulates a fifo cache using timestamps, returns the amount of misses
+u32 update_cache(const mesh_index* tri, vector<u32>& timestamps, u32& timestamp)
+{
+    u32 misses = 0;
+    for (u32 k = 0; k < 3; k++) {
+        if (timestamp - timestamps[tri[k]] > cache_sim_size) {
+            timestamps[tri[k]] = timestamp++;
+            misses++;
+        }
+    }
+    return misses;
+}
+} // namespace
+
+void optimize_vertex_cache(mesh_indices& indices, u32 vertex_count)
+{
+    const u32 tri_count = u32(indices.size() / 3);
+
+    if (tri_count == 0)
+        return;
+
+    // Vertex -> triangle adjacency
+    vector<u32> remaining(vertex_count, 0);
+    for (auto i : indices) {
+        remaining[i]++;
+    }
+
+    vector<u32> offsets(vertex_count + 1, 0);
+    std::partial_sum(remaining.begin(), remaining.end(), offsets.begin() + 1);
+
+    vector<u32> adjacency(indices.size());
+    {
+        vector<u32> fill(offsets.begin(), offsets.end() - 1);
+        for (u32 t = 0; t < tri_count; t++) {
+            for (u32 k = 0; k < 3; k++) {
+                adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+    }
+
+    vector<i32> cache_pos(vertex_count, -1);
+    vector<f32> scores(vertex_count);
+    for (u32 v = 0; v < vertex_count; v++) {
+        scores[v] = vertex_score(-1, remaining[v]);
+    }
+
+    vector<f32> tri_scores(tri_count);
+    vector<bool> emitted(tri_count, false);
+
+    u32 best_tri = invalid;
+    f32 best_score = -1.f;
+
+    for (u32 t = 0; t < tri_count; t++) {
+        const auto* tri = &indices[t * 3];
+        tri_scores[t] = scores[tri[0]] + scores[tri[1]] + scores[tri[2]];
+
+        if (tri_scores[t] > best_score) {
+            best_score = tri_scores[t];
+            best_tri = t;
+        }
+    }
+
+    vector<u32> cache, next_cache;
+    cache.reserve(cache_size + 3);
+    next_cache.reserve(cache_size + 3);
+
+    mesh_indices result;
+    result.reserve(indices.size());
+
+    u32 cursor = 0;
+
+    while (result.size() < indices.size()) {
+        if (best_tri == invalid) {
+            // Cache ran dry, continue with the next unprocessed triangle
+            while (emitted[cursor]) {
+                cursor++;
+            }
+            best_tri = cursor;
+        }
+
+        const auto* tri = &indices[best_tri * 3];
+        emitted[best_tri] = true;
+
+        next_cache.clear();
+
+        for (u32 k = 0; k < 3; k++) {
+            const auto v = tri[k];
+            result.push_back(v);
+            next_cache.push_back(v);
+
+            // Remove triangle from the vertex's live adjacency
+            auto begin = adjacency.begin() + offsets[v];
+            auto end = begin + remaining[v];
+            auto it = std::find(begin, end, best_tri);
+            std::iter_swap(it, end - 1);
+            remaining[v]--;
+        }
+
+        for (auto v : cache) {
+            if (v != tri[0] && v != tri[1] && v != tri[2]) {
+                next_cache.push_back(v);
+            }
+        }
+
+        // Update scores, entries pushed past the cache size are evicted
+        for (u32 i = 0; i < next_cache.size(); i++) {
+            const auto v = next_cache[i];
+            cache_pos[v] = i < cache_size ? i32(i) : -1;
+            scores[v] = vertex_score(cache_pos[v], remaining[v]);
+        }
+
+        best_tri = invalid;
+        best_score = -1.f;
+
+        for (auto v : next_cache) {
+            for (u32 a = offsets[v]; a < offsets[v] + remaining[v]; a++) {
+                const auto t = adjacency[a];
+                const auto* adj = &indices[t * 3];
+
+                tri_scores[t] = scores[adj[0]] + scores[adj[1]] + scores[adj[2]];
+
+                if (tri_scores[t] > best_score) {
+                    best_score = tri_scores[t];
+                    best_tri = t;
+                }
+            }
+        }
+
+        next_cache.resize(std::min<size_t>(next_cache.size(), cache_size));
+        std::swap(cache, next_cache);
+    }
+
+    indices = std::move(result);
+}
+
+void optimize_overdraw(mesh_indices& indices, const vector<v3>& positions, f32 threshold)
+{
+    // https://gfx.cs.princeton.edu/pubs/Sander_2007_%3ETR/tipsy.pdf
+    const u32 tri_count = u32(indices.size() / 3);
+
+    if (tri_count == 0)
+        return;
+
+    vector<u32> timestamps(positions.size(), 0);
+    u32 timestamp = cache_sim_size + 1;
+
+    // Hard boundaries, where the cache has been fully flushed
+    vector<u32> hard{ 0 };
+    for (u32 t = 0; t < tri_count; t++) {
+        if (update_cache(&indices[t * 3], timestamps, timestamp) == 3 && t > 0) {
+            hard.push_back(t);
+        }
+    }
+    hard.push_back(tri_count);
+
+    // Soft boundaries, split where it doesn't hurt the cluster acmr too much
+    vector<u32> clusters;
+    for (u32 h = 0; h + 1 < hard.size(); h++) {
+        const auto start = hard[h];
+        const auto end = hard[h + 1];
+
+        timestamp += cache_sim_size + 1;
+
+        u32 cluster_misses = 0;
+        for (u32 t = start; t < end; t++) {
+            cluster_misses += update_cache(&indices[t * 3], timestamps, timestamp);
+        }
+
+        const f32 cluster_threshold = threshold * f32(cluster_misses) / f32(end - start);
+
+        clusters.push_back(start);
+        timestamp += cache_sim_size + 1;
+
+        u32 running_misses = 0;
+        u32 running_faces = 0;
+
+        for (u32 t = start; t < end; t++) {
+            running_misses += update_cache(&indices[t * 3], timestamps, timestamp);
+            running_faces++;
+
+            if (f32(running_misses) / f32(running_faces) <= cluster_threshold &&
+                t + 1 < end) {
+                clusters.push_back(t + 1);
+                timestamp += cache_sim_size + 1;
+                running_misses = 0;
+                running_faces = 0;
+            }
+        }
+    }
+    clusters.push_back(tri_count);
+
+    // Area weighted centroid & normal per cluster
+    const u32 cluster_count = u32(clusters.size() - 1);
+
+    vector<v3> centroids(cluster_count, v3{ 0.f });
+    vector<v3> normals(cluster_count, v3{ 0.f });
+    vector<f32> areas(cluster_count, 0.f);
+
+    v3 mesh_centroid{ 0.f };
+    f32 mesh_area = 0.f;
+
+    for (u32 c = 0; c < cluster_count; c++) {
+        for (u32 t = clusters[c]; t < clusters[c + 1]; t++) {
+            const auto& p0 = positions[indices[t * 3 + 0]];
+            const auto& p1 = positions[indices[t * 3 + 1]];
+            const auto& p2 = positions[indices[t * 3 + 2]];
+
+            const auto n = glm::cross(p1 - p0, p2 - p0);
+            const auto area = glm::length(n);
+
+            centroids[c] += (p0 + p1 + p2) * (area / 3.f);
+            normals[c] += n;
+            areas[c] += area;
+        }
+
+        mesh_centroid += centroids[c];
+        mesh_area += areas[c];
+    }
+
+    mesh_centroid /= mesh_area > 0.f ? mesh_area : 1.f;
+
+    vector<f32> sort_keys(cluster_count, 0.f);
+    for (u32 c = 0; c < cluster_count; c++) {
+        const auto centroid = centroids[c] / (areas[c] > 0.f ? areas[c] : 1.f);
+        const auto length = glm::length(normals[c]);
+        const auto normal = length > 0.f ? normals[c] / length : v3{ 0.f };
+
+        sort_keys[c] = glm::dot(centroid - mesh_centroid, normal);
+    }
+
+    // Outward facing clusters first
+    vector<u32> order(cluster_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+        [&](u32 a, u32 b) { return sort_keys[a] > sort_keys[b]; });
+
+    mesh_indices result;
+    result.reserve(indices.size());
+
+    for (auto c : order) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3,
+            indices.begin() + clusters[c + 1] * 3);
+    }
+
+    indices = std::move(result);
+}
+
+void optimize_vertex_fetch(vertex::list& vertices, mesh_indices& indices)
+{
+    vector<u32> remap(vertices.size(), invalid);
+    u32 next = 0;
+
+    for (auto& i : indices) {
+        if (remap[i] == invalid) {
+            remap[i] = next++;
+        }
+        i = remap[i];
+    }
+
+    vertex::list result(next);
+    for (u32 v = 0; v < vertices.size(); v++) {
+        if (remap[v] != invalid) {
+            result[remap[v]] = vertices[v];
+        }
+    }
+
+    vertices = std::move(result);
+}
+
+void optimize(mesh_primitive::data& data)
+{
+    if (!data.has_indices() || !data.has_vertices())
+        return;
+
+    optimize_vertex_cache(data.indices, u32(data.vertices.size()));
+
+    vector<v3> positions;
+    positions.reserve(data.vertices.size());
+    std::transform(data.vertices.begin(), data.vertices.end(),
+        std::back_inserter(positions), [](const vertex& v) { return v3(v.pos, 0.f); });
+
+    optimize_overdraw(data.indices, positions);
+    optimize_vertex_fetch(data.vertices, data.indices);
+}
+} // namespace mesh_utils
+} // namespace bnr
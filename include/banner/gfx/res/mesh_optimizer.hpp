@@ -0,0 +1,40 @@
+#pragma once
+
+#include <banner/core/types.hpp>
+#include <banner/gfx/res/mesh.hpp>
+
+namespace bnr {
+namespace mesh_utils {
+/**
+ * @brief Reorders triangles for the post-transform vertex cache (Forsyth).
+ */
+void optimize_vertex_cache(mesh_indices& indices, u32 vertex_count);
+
+/**
+ * @brief Reorders clusters of cache-optimized triangles so outward facing clusters
+ * are drawn first. A cluster may only be split if its ACMR stays below
+ * `threshold` times the original.
+ */
+void optimize_overdraw(
+    mesh_indices& indices, const vector<v3>& positions, f32 threshold = 1.05f);
+
+/**
+ * @brief Reorders vertices in the order they are first referenced by the index
+ * buffer and drops unreferenced vertices.
+ */
+void optimize_vertex_fetch(vertex::list& vertices, mesh_indices& indices);
+
+/**
+ * @brief Runs the full import-time pipeline (cache, overdraw, fetch).
+ */
+void optimize(mesh_primitive::data& data);
+
+/**
+ * @brief Returns true if every index fits an `eUint16` index buffer.
+ */
+inline bool fits_u16(const mesh_primitive::data& data)
+{
+    return data.vertices.size() <= 0xFFFF;
+}
+} // namespace mesh_utils
+} // namespace bnr
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <bit>
+
+#include <banner/gfx/graphics.hpp>
+#include <banner/gfx/res/texture.hpp>
+#include <banner/gfx/vk_utils.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+using vk_utils::success;
+
+namespace {
+void transition(vk::CommandBuffer cmd, vk::Image image, u32 mip, u32 count,
+    vk::ImageLayout from, vk::ImageLayout to, vk::AccessFlags src_access,
+    vk::AccessFlags dst_access, vk::PipelineStageFlags src_stage,
+    vk::PipelineStageFlags dst_stage)
+{
+    vk::ImageMemoryBarrier barrier{ src_access, dst_access, from, to,
+        VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, image,
+        { vk::ImageAspectFlagBits::eColor, mip, count, 0, 1 } };
+
+    cmd.pipelineBarrier(src_stage, dst_stage, {}, nullptr, nullptr, barrier);
+}
+} // namespace
+
+texture::texture(graphics* ctx)
+    : ctx_{ ctx }
+{}
+
+texture::~texture()
+{
+    const auto deletions = ctx_->deletions();
+    deletions->push(std::move(view_));
+
+    if (image_) {
+        deletions->push([mem = ctx_->memory(), image = image_,
+                            allocation = allocation_, size = size_]() {
+            vmaDestroyImage(mem->allocator(), image, allocation);
+            mem->untrack(memory::category::texture, size);
+        });
+    }
+}
+
+void texture::create(const info& info)
+{
+    info_ = info;
+
+    vk::ImageCreateInfo image_create_info{ {}, vk::ImageType::e2D, info.format,
+        { info.width, info.height, 1 }, info.mip_levels, 1, vk::SampleCountFlagBits::e1,
+        vk::ImageTiling::eOptimal,
+        vk::ImageUsageFlagBits::eTransferSrc | vk::ImageUsageFlagBits::eTransferDst |
+            vk::ImageUsageFlagBits::eSampled,
+        vk::SharingMode::eExclusive };
+
+    VmaAllocationCreateInfo allocation_create_info{
+        .usage{ VMA_MEMORY_USAGE_GPU_ONLY },
+    };
+
+    VmaAllocationInfo allocation_info{};
+
+    if (!success(vmaCreateImage(ctx_->memory()->allocator(),
+            reinterpret_cast<VkImageCreateInfo*>(&image_create_info),
+            &allocation_create_info, reinterpret_cast<VkImage*>(&image_), &allocation_,
+            &allocation_info))) {
+        debug::fatal("Failed to create texture image!");
+    }
+
+    size_ = allocation_info.size;
+    ctx_->memory()->track(memory::category::texture, size_);
+
+    view_ = ctx_->device()->vk().createImageViewUnique(
+        { {}, image_, vk::ImageViewType::e2D, info.format, {},
+            { vk::ImageAspectFlagBits::eColor, 0, info.mip_levels, 0, 1 } },
+        ctx_->device()->callbacks(vk::ObjectType::eImageView));
+}
+
+void texture::record_upload(
+    vk::CommandBuffer cmd, vk::Buffer staging, vk::DeviceSize offset)
+{
+    using access = vk::AccessFlagBits;
+    using layout = vk::ImageLayout;
+    using stage = vk::PipelineStageFlagBits;
+
+    const auto levels = info_.mip_levels;
+
+    transition(cmd, image_, 0, levels, layout::eUndefined, layout::eTransferDstOptimal,
+        {}, access::eTransferWrite, stage::eTopOfPipe, stage::eTransfer);
+
+    vk::BufferImageCopy region{ offset, 0, 0,
+        { vk::ImageAspectFlagBits::eColor, 0, 0, 1 }, { 0, 0, 0 },
+        { info_.width, info_.height, 1 } };
+
+    cmd.copyBufferToImage(staging, image_, layout::eTransferDstOptimal, region);
+
+    // Each level is blitted from the previous one, then handed to the shaders
+    auto w = i32(info_.width);
+    auto h = i32(info_.height);
+
+    for (u32 i = 1; i < levels; i++) {
+        transition(cmd, image_, i - 1, 1, layout::eTransferDstOptimal,
+            layout::eTransferSrcOptimal, access::eTransferWrite, access::eTransferRead,
+            stage::eTransfer, stage::eTransfer);
+
+        const auto next_w = std::max(w / 2, 1);
+        const auto next_h = std::max(h / 2, 1);
+
+        vk::ImageBlit blit{ { vk::ImageAspectFlagBits::eColor, i - 1, 0, 1 },
+            { vk::Offset3D{ 0, 0, 0 }, vk::Offset3D{ w, h, 1 } },
+            { vk::ImageAspectFlagBits::eColor, i, 0, 1 },
+            { vk::Offset3D{ 0, 0, 0 }, vk::Offset3D{ next_w, next_h, 1 } } };
+
+        cmd.blitImage(image_, layout::eTransferSrcOptimal, image_,
+            layout::eTransferDstOptimal, blit, vk::Filter::eLinear);
+
+        transition(cmd, image_, i - 1, 1, layout::eTransferSrcOptimal,
+            layout::eShaderReadOnlyOptimal, access::eTransferRead, access::eShaderRead,
+            stage::eTransfer, stage::eFragmentShader);
+
+        w = next_w;
+        h = next_h;
+    }
+
+    transition(cmd, image_, levels - 1, 1, layout::eTransferDstOptimal,
+        layout::eShaderReadOnlyOptimal, access::eTransferWrite, access::eShaderRead,
+        stage::eTransfer, stage::eFragmentShader);
+}
+
+void texture::record_levels(
+    vk::CommandBuffer cmd, vk::Buffer staging, const vector<vk::DeviceSize>& offsets)
+{
+    using access = vk::AccessFlagBits;
+    using layout = vk::ImageLayout;
+    using stage = vk::PipelineStageFlagBits;
+
+    const auto levels = info_.mip_levels;
+
+    transition(cmd, image_, 0, levels, layout::eUndefined, layout::eTransferDstOptimal,
+        {}, access::eTransferWrite, stage::eTopOfPipe, stage::eTransfer);
+
+    vector<vk::BufferImageCopy> regions;
+    regions.reserve(levels);
+
+    for (u32 i = 0; i < levels; i++) {
+        const vk::Extent3D extent{ std::max(info_.width >> i, 1u),
+            std::max(info_.height >> i, 1u), 1 };
+
+        regions.push_back({ offsets[i], 0, 0,
+            { vk::ImageAspectFlagBits::eColor, i, 0, 1 }, { 0, 0, 0 }, extent });
+    }
+
+    cmd.copyBufferToImage(staging, image_, layout::eTransferDstOptimal, regions);
+
+    transition(cmd, image_, 0, levels, layout::eTransferDstOptimal,
+        layout::eShaderReadOnlyOptimal, access::eTransferWrite, access::eShaderRead,
+        stage::eTransfer, stage::eFragmentShader);
+}
+
+u32 texture::mip_count(u32 width, u32 height)
+{
+    return u32(std::bit_width(std::max({ width, height, 1u })));
+}
+} // namespace bnr
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+
+#include <vk_mem_alloc.h>
+
+#include <banner/core/types.hpp>
+#include <banner/gfx/res/resource.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct graphics;
+
+/**
+ * @brief Sampled 2d image with a full mip chain. Textures are created empty and
+ * filled asynchronously by the `texture_loader`, only `ready` textures may be bound.
+ */
+struct texture : resource
+{
+    friend struct texture_loader;
+    friend struct texture_streamer;
+
+    enum class status : u32
+    {
+        pending,
+        ready,
+        failed
+    };
+
+    struct info
+    {
+        u32 width{ 0 };
+        u32 height{ 0 };
+        u32 mip_levels{ 1 };
+        vk::Format format{ vk::Format::eR8G8B8A8Srgb };
+    };
+
+    explicit texture(graphics* ctx);
+    ~texture();
+
+    /**
+     * @brief Allocates the image & view, contents are undefined until uploaded.
+     */
+    void create(const info& info);
+
+    /**
+     * @brief Records the copy of mip 0 from `staging` and the blits generating the
+     * remaining mips, leaves every level in `eShaderReadOnlyOptimal`.
+     */
+    void record_upload(vk::CommandBuffer cmd, vk::Buffer staging, vk::DeviceSize offset);
+
+    /**
+     * @brief Records copies of every mip level from `staging`, `offsets` holds one
+     * offset per level.
+     */
+    void record_levels(vk::CommandBuffer cmd, vk::Buffer staging,
+        const vector<vk::DeviceSize>& offsets);
+
+    auto vk() const { return image_; }
+    auto view() const { return view_.get(); }
+    auto ctx() { return ctx_; }
+
+    const auto& get_info() const { return info_; }
+    auto size() const { return size_; }
+    auto state() const { return status_.load(std::memory_order_acquire); }
+    auto ready() const { return state() == status::ready; }
+
+    vk::DescriptorImageInfo descriptor(vk::Sampler sampler) const
+    {
+        return { sampler, view_.get(), vk::ImageLayout::eShaderReadOnlyOptimal };
+    }
+
+    static u32 mip_count(u32 width, u32 height);
+
+private:
+    graphics* ctx_;
+
+    vk::Image image_;
+    VmaAllocation allocation_{ nullptr };
+    vk::UniqueImageView view_;
+    vk::DeviceSize size_{ 0 };
+
+    info info_;
+    std::atomic<status> status_{ status::pending };
+};
+} // namespace bnr
@@ -0,0 +1,50 @@
+#include <algorithm>
+
+#include <banner/gfx/device.hpp>
+#include <banner/gfx/sampler_cache.hpp>
+
+namespace bnr {
+size_t sampler_cache::hasher::operator()(const desc& desc) const
+{
+    size_t seed{ 0 };
+
+    auto combine = [&](auto value) {
+        const auto hash = std::hash<decltype(value)>{}(value);
+        seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    };
+
+    combine(u32(desc.filter));
+    combine(u32(desc.mipmap));
+    combine(u32(desc.address));
+    combine(desc.anisotropy);
+    combine(desc.max_lod);
+
+    return seed;
+}
+
+sampler_cache::sampler_cache(bnr::device* device)
+    : device_{ device }
+{}
+
+vk::Sampler sampler_cache::get(const desc& desc)
+{
+    auto it = samplers_.find(desc);
+
+    if (it != samplers_.end())
+        return it->second.get();
+
+    const auto anisotropy =
+        std::min(desc.anisotropy, device_->limits().maxSamplerAnisotropy);
+
+    vk::SamplerCreateInfo info{ {}, desc.filter, desc.filter, desc.mipmap, desc.address,
+        desc.address, desc.address, 0.f, anisotropy > 1.f, anisotropy, false,
+        vk::CompareOp::eNever, 0.f, desc.max_lod };
+
+    auto sampler = device_->vk().createSamplerUnique(
+        info, device_->callbacks(vk::ObjectType::eSampler));
+    auto handle = sampler.get();
+
+    samplers_.emplace(desc, std::move(sampler));
+    return handle;
+}
+} // namespace bnr
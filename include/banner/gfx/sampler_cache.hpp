@@ -0,0 +1,43 @@
+#pragma once
+
+#include <unordered_map>
+
+#include <banner/core/types.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct device;
+
+/**
+ * @brief Deduplicates samplers, equal descriptions share one vk::Sampler.
+ */
+struct sampler_cache
+{
+    struct desc
+    {
+        vk::Filter filter{ vk::Filter::eLinear };
+        vk::SamplerMipmapMode mipmap{ vk::SamplerMipmapMode::eLinear };
+        vk::SamplerAddressMode address{ vk::SamplerAddressMode::eRepeat };
+        f32 anisotropy{ 0.f };
+        f32 max_lod{ VK_LOD_CLAMP_NONE };
+
+        bool operator==(const desc&) const = default;
+    };
+
+    explicit sampler_cache(bnr::device* device);
+
+    vk::Sampler get(const desc& desc);
+    vk::Sampler get() { return get(desc{}); }
+
+    auto size() const { return u32(samplers_.size()); }
+
+private:
+    struct hasher
+    {
+        size_t operator()(const desc& desc) const;
+    };
+
+    bnr::device* device_;
+    std::unordered_map<desc, vk::UniqueSampler, hasher> samplers_;
+};
+} // namespace bnr
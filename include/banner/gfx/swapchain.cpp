@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+
+#include <banner/gfx/deletion_queue.hpp>
 #include <banner/gfx/device.hpp>
 #include <banner/gfx/swapchain.hpp>
 #include <banner/gfx/vk_utils.hpp>
@@ -16,14 +19,32 @@ inline vk::SurfaceFormatKHR choose_format(const vector<vk::SurfaceFormatKHR>& fo
     return formats[0];
 }
 
-inline vk::PresentModeKHR choose_present_mode(const vector<vk::PresentModeKHR>& modes)
+inline vk::PresentModeKHR choose_present_mode(
+    const vector<vk::PresentModeKHR>& modes, swapchain::policy policy)
 {
-    for (const auto& mode : modes) {
-        if (mode == vk::PresentModeKHR::eMailbox) {
-            return mode;
-        }
+    using mode = vk::PresentModeKHR;
+
+    auto supported = [&](mode m) {
+        return std::find(modes.begin(), modes.end(), m) != modes.end();
+    };
+
+    switch (policy) {
+    case swapchain::policy::low_latency:
+        if (supported(mode::eMailbox))
+            return mode::eMailbox;
+        break;
+    case swapchain::policy::uncapped:
+        if (supported(mode::eImmediate))
+            return mode::eImmediate;
+        if (supported(mode::eMailbox))
+            return mode::eMailbox;
+        break;
+    default:
+        break;
     }
-    return vk::PresentModeKHR::eFifoRelaxed;
+
+    // Fifo is the only mode every surface has to support
+    return mode::eFifo;
 }
 
 vk::Extent2D choose_extent(
@@ -40,11 +61,14 @@ vk::Extent2D choose_extent(
     }
 }
 
-swapchain::swapchain(bnr::device* device, vk::SurfaceKHR surface, const uv2& size)
+swapchain::swapchain(bnr::device* device, deletion_queue* deletions,
+    vk::SurfaceKHR surface, const uv2& size, policy present)
 {
     surface_ = surface;
     device_ = device;
+    deletions_ = deletions;
     extent_ = { size.x, size.y };
+    policy_ = present;
 
     create_vk_swapchain();
 }
@@ -62,14 +86,19 @@ void swapchain::create_vk_swapchain()
     auto [capabilities, formats, modes] =
         vk_utils::get_surface_info(device_->physical(), surface_);
 
-    mode_ = choose_present_mode(modes);
+    mode_ = choose_present_mode(modes, policy_);
     format_ = choose_format(formats);
     extent_ = choose_extent(capabilities, extent_);
 
-    auto image_count = std::min<u32>(
-        std::max<u32>(capabilities.minImageCount, 2), capabilities.maxImageCount);
+    auto image_count = std::max<u32>(capabilities.minImageCount, 2);
 
-    auto old_swapchain = vk_swapchain_.get();
+    // A max of 0 means there's no limit
+    if (capabilities.maxImageCount > 0) {
+        image_count = std::min(image_count, capabilities.maxImageCount);
+    }
+
+    // Frames in flight may still present from the old swapchain
+    auto old_swapchain = std::move(vk_swapchain_);
 
     // Determine transformation to use (preferring no transform)
     vk::SurfaceTransformFlagBitsKHR surface_transform;
@@ -95,20 +124,21 @@ void swapchain::create_vk_swapchain()
     create_info.setCompositeAlpha(vk::CompositeAlphaFlagBitsKHR::eOpaque);
     create_info.setPresentMode(mode_);
     create_info.setClipped(VK_TRUE);
-    create_info.setOldSwapchain(old_swapchain);
+    create_info.setOldSwapchain(old_swapchain.get());
 
-    vk_swapchain_ = device_->vk().createSwapchainKHRUnique(create_info);
+    vk_swapchain_ = device_->vk().createSwapchainKHRUnique(
+        create_info, device_->callbacks(vk::ObjectType::eSwapchainKHR));
 
     create_imageviews();
 
-    if (old_swapchain) {
-        device_->vk().destroySwapchainKHR(old_swapchain);
-        old_swapchain = nullptr;
-    }
+    deletions_->push(std::move(old_swapchain));
 }
 
 void swapchain::create_imageviews()
 {
+    for (auto& view : data_.views) {
+        deletions_->push(std::move(view));
+    }
 
     data_.images.clear();
     data_.views.clear();
@@ -123,18 +153,35 @@ void swapchain::create_imageviews()
                 1, // level count
                 0, // baseArraylayers
                 1) // layers count
-        }));
+            },
+            device_->callbacks(vk::ObjectType::eImageView)));
     }
 }
 
 void swapchain::resize(const uv2& size)
 {
-    device_->vk().waitIdle();
+    // Minimized, there's nothing to present to
+    if (size.x == 0 || size.y == 0)
+        return;
 
     extent_ = { size.x, size.y };
     create_vk_swapchain();
 
-    on_recreate.fire();
+    events.fire<"recreate">();
+}
+
+void swapchain::set_policy(policy present)
+{
+    if (present == policy_)
+        return;
+
+    policy_ = present;
+
+    const auto modes = device_->physical().getSurfacePresentModesKHR(surface_);
+    if (choose_present_mode(modes, policy_) == mode_)
+        return;
+
+    resize({ extent_.width, extent_.height });
 }
 
 vk::ResultValue<u32> swapchain::aquire_image(
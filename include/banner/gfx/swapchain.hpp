@@ -3,16 +3,31 @@
 #include <vector>
 
 #include <banner/core/types.hpp>
-#include <banner/util/signal.hpp>
+#include <banner/util/event.hpp>
 #include <vulkan/vulkan.hpp>
 
 namespace bnr {
 struct device;
+struct deletion_queue;
 
 struct swapchain
 {
+    /**
+     * @brief How frames are presented, falls back to vsync when the surface doesn't
+     * support the preferred modes.
+     * - low_latency: mailbox, no tearing & the newest frame replaces queued ones
+     * - vsync: fifo, frames queue up behind the vertical blank
+     * - uncapped: immediate, tears but never waits
+     */
+    enum class policy
+    {
+        low_latency,
+        vsync,
+        uncapped
+    };
 
-    explicit swapchain(device* device, vk::SurfaceKHR surface, const uv2& size);
+    swapchain(device* device, deletion_queue* deletions, vk::SurfaceKHR surface,
+        const uv2& size, policy present);
     ~swapchain();
 
     struct swapchain_data
@@ -24,8 +39,20 @@ struct swapchain
     vk::ResultValue<u32> aquire_image(
         vk::Semaphore sem, vk::Fence fence = nullptr, u32 timeout = u32(-1));
 
+    /**
+     * @brief Recreates the swapchain, the old one is handed over to the new one &
+     * destroyed with its views once the frames in flight are done.
+     */
     void resize(const uv2& size);
-    signal<void()> on_recreate;
+    // Every render pass connects its framebuffers
+    event_bus<event<"recreate", void(), 32>> events;
+
+    /**
+     * @brief Recreates the swapchain if `present` picks another mode.
+     */
+    void set_policy(policy present);
+    auto present_policy() const { return policy_; }
+    auto present_mode() const { return mode_; }
 
     auto vk() const { return vk_swapchain_.get(); }
     auto device() { return device_; }
@@ -38,11 +65,13 @@ struct swapchain
 
 private:
     bnr::device* device_;
+    deletion_queue* deletions_;
     vk::SurfaceKHR surface_;
 
     vk::SurfaceFormatKHR format_;
     vk::Extent2D extent_;
     vk::PresentModeKHR mode_;
+    policy policy_;
 
     vk::UniqueSwapchainKHR vk_swapchain_;
 
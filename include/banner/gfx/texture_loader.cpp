@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cstring>
+
+#include <stb_image.h>
+
+#include <banner/gfx/graphics.hpp>
+#include <banner/gfx/texture_loader.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+texture_loader::texture_loader(graphics* ctx, bnr::jobs* jobs, options opts)
+    : ctx_{ ctx }
+    , jobs_{ jobs }
+    , opts_{ opts }
+{
+    pool_ = ctx_->device()->vk().createCommandPoolUnique(
+        { vk::CommandPoolCreateFlagBits::eTransient,
+            ctx_->device()->queue().graphics_index },
+        ctx_->device()->callbacks(vk::ObjectType::eCommandPool));
+
+    staging_ = ctx_->memory()->pool(
+        vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY);
+}
+
+texture_loader::~texture_loader()
+{
+    // Decode jobs capture `this`, wait for them before tearing down
+    jobs_->wait(decoding_);
+
+    for (auto& image : decoded_) {
+        stbi_image_free(image.pixels);
+    }
+
+    for (auto& upload : uploads_) {
+        std::ignore = ctx_->device()->vk().waitForFences(upload.fence, true, UINT64_MAX);
+        retire(upload);
+    }
+}
+
+sptr<texture> texture_loader::load(str_ref path, bool srgb)
+{
+    const str key{ path };
+
+    if (auto it = cache_.find(key); it != cache_.end()) {
+        if (auto cached = it->second.lock())
+            return cached;
+    }
+
+    auto result = std::make_shared<texture>(ctx_);
+    cache_[key] = result;
+
+    jobs_->run([this, result, key, srgb]() { decode(result, key, srgb); }, &decoding_);
+
+    return result;
+}
+
+void texture_loader::update()
+{
+    const auto device = ctx_->device()->vk();
+
+    std::erase_if(uploads_, [&](upload& upload) {
+        if (device.getFenceStatus(upload.fence) != vk::Result::eSuccess)
+            return false;
+
+        retire(upload);
+        return true;
+    });
+
+    // Take what fits in this frame's budget, the rest waits for the next one
+    vector<decoded> batch;
+    {
+        std::lock_guard lock{ mutex_ };
+
+        vk::DeviceSize bytes{ 0 };
+        auto it = decoded_.begin();
+
+        while (it != decoded_.end() && batch.size() < opts_.max_uploads) {
+            const auto size = vk::DeviceSize(it->width) * it->height * 4;
+
+            if (!batch.empty() && bytes + size > opts_.max_upload_bytes)
+                break;
+
+            bytes += size;
+            batch.push_back(*it++);
+        }
+
+        decoded_.erase(decoded_.begin(), it);
+    }
+
+    for (auto& image : batch) {
+        submit(image);
+    }
+
+    // Drop cache entries of textures nobody holds anymore
+    std::erase_if(cache_, [](const auto& entry) { return entry.second.expired(); });
+}
+
+u32 texture_loader::pending() const
+{
+    std::lock_guard lock{ mutex_ };
+    return decoding_.value() + u32(decoded_.size()) + u32(uploads_.size());
+}
+
+void texture_loader::decode(sptr<texture> target, str path, bool srgb)
+{
+    i32 w, h;
+    auto pixels = stbi_load(path.c_str(), &w, &h, nullptr, 4);
+
+    if (!pixels) {
+        debug::err("Failed to load texture %s: %s", path.c_str(), stbi_failure_reason());
+        target->status_.store(texture::status::failed, std::memory_order_release);
+        return;
+    }
+
+    std::lock_guard lock{ mutex_ };
+    decoded_.push_back({ std::move(target), pixels, u32(w), u32(h), srgb });
+}
+
+void texture_loader::submit(decoded& image)
+{
+    const auto device = ctx_->device()->vk();
+    const auto format =
+        image.srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+
+    // Mips are generated with linear blits, fall back to a single level without them
+    const auto levels =
+        blit_supported(format) ? texture::mip_count(image.width, image.height) : 1;
+
+    image.target->create({ image.width, image.height, levels, format });
+
+    const auto size = vk::DeviceSize(image.width) * image.height * 4;
+    auto staging = staging_->allocate(size);
+
+    if (!staging.valid()) {
+        debug::err("Failed to allocate %llu staging bytes for a texture", u64(size));
+        stbi_image_free(image.pixels);
+        image.target->status_.store(texture::status::failed, std::memory_order_release);
+        return;
+    }
+
+    std::memcpy(staging.mapped, image.pixels, size);
+    stbi_image_free(image.pixels);
+
+    auto cmd = device.allocateCommandBuffers(
+        { pool_.get(), vk::CommandBufferLevel::ePrimary, 1 })[0];
+
+    cmd.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    image.target->record_upload(cmd, staging.buffer, staging.offset);
+    cmd.end();
+
+    auto fence =
+        device.createFence({}, ctx_->device()->callbacks(vk::ObjectType::eFence));
+
+    vk::SubmitInfo submit_info;
+    submit_info.setCommandBufferCount(1);
+    submit_info.setPCommandBuffers(&cmd);
+    ctx_->device()->queue().submit(submit_info, fence);
+
+    uploads_.push_back({ std::move(image.target), staging, cmd, fence });
+}
+
+void texture_loader::retire(upload& upload)
+{
+    const auto device = ctx_->device()->vk();
+
+    staging_->free(upload.staging);
+    device.freeCommandBuffers(pool_.get(), upload.cmd);
+    device.destroyFence(upload.fence, ctx_->device()->callbacks(vk::ObjectType::eFence));
+
+    upload.target->status_.store(texture::status::ready, std::memory_order_release);
+}
+
+bool texture_loader::blit_supported(vk::Format format)
+{
+    auto [it, inserted] = blit_support_.try_emplace(VkFormat(format), false);
+
+    if (inserted) {
+        const auto props = ctx_->device()->physical().getFormatProperties(format);
+        it->second = bool(props.optimalTilingFeatures &
+            vk::FormatFeatureFlagBits::eSampledImageFilterLinear);
+    }
+
+    return it->second;
+}
+} // namespace bnr
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include <banner/core/jobs.hpp>
+#include <banner/core/types.hpp>
+#include <banner/gfx/buffer_pool.hpp>
+#include <banner/gfx/res/texture.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct graphics;
+
+/**
+ * @brief Loads textures without blocking the frame loop. Files are decoded on worker
+ * threads, uploads are recorded by the engine loop in `update` and polled through
+ * their fences on later frames.
+ */
+struct texture_loader
+{
+    struct options
+    {
+        u32 max_uploads{ 8 };
+        vk::DeviceSize max_upload_bytes{ 64 * 1024 * 1024 };
+    };
+
+    explicit texture_loader(graphics* ctx, bnr::jobs* jobs, options opts);
+    ~texture_loader();
+
+    /**
+     * @brief Returns immediately with a pending texture, files already loaded (or in
+     * flight) are shared.
+     */
+    sptr<texture> load(str_ref path, bool srgb = true);
+
+    /**
+     * @brief Retires finished uploads and starts new ones within the per frame
+     * budget, called once per frame from the engine loop.
+     */
+    void update();
+
+    u32 pending() const;
+
+private:
+    struct decoded
+    {
+        sptr<texture> target;
+        uc8* pixels;
+        u32 width;
+        u32 height;
+        bool srgb;
+    };
+
+    struct upload
+    {
+        sptr<texture> target;
+        buffer_pool::slice staging;
+        vk::CommandBuffer cmd;
+        vk::Fence fence;
+    };
+
+    void decode(sptr<texture> target, str path, bool srgb);
+    void submit(decoded& image);
+    void retire(upload& upload);
+
+    bool blit_supported(vk::Format format);
+
+    graphics* ctx_;
+    bnr::jobs* jobs_;
+    options opts_;
+
+    vk::UniqueCommandPool pool_;
+    buffer_pool* staging_;
+
+    mutable std::mutex mutex_;
+    vector<decoded> decoded_;
+    jobs::counter decoding_;
+
+    vector<upload> uploads_;
+    std::unordered_map<str, std::weak_ptr<texture>> cache_;
+    std::unordered_map<VkFormat, bool> blit_support_;
+};
+} // namespace bnr
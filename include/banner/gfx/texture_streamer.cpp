@@ -0,0 +1,447 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <stb_image.h>
+
+#include <banner/gfx/graphics.hpp>
+#include <banner/gfx/renderer.hpp>
+#include <banner/gfx/texture_streamer.hpp>
+#include <banner/util/debug.hpp>
+
+namespace bnr {
+namespace {
+// 2x2 box filter, edge texels are repeated for odd sizes
+template<typename Level>
+Level downsample(const Level& src)
+{
+    Level dst{ std::max(src.width / 2, 1u), std::max(src.height / 2, 1u), {} };
+    dst.pixels.resize(size_t(dst.width) * dst.height * 4);
+
+    auto texel = [&](u32 x, u32 y, u32 c) -> u32 {
+        x = std::min(x, src.width - 1);
+        y = std::min(y, src.height - 1);
+        return src.pixels[(size_t(y) * src.width + x) * 4 + c];
+    };
+
+    for (u32 y = 0; y < dst.height; y++) {
+        for (u32 x = 0; x < dst.width; x++) {
+            for (u32 c = 0; c < 4; c++) {
+                const auto sum = texel(x * 2, y * 2, c) + texel(x * 2 + 1, y * 2, c) +
+                    texel(x * 2, y * 2 + 1, c) + texel(x * 2 + 1, y * 2 + 1, c);
+
+                dst.pixels[(size_t(y) * dst.width + x) * 4 + c] = uc8((sum + 2) / 4);
+            }
+        }
+    }
+
+    return dst;
+}
+} // namespace
+
+texture_streamer::texture_streamer(
+    graphics* ctx, renderer* renderer, bnr::jobs* jobs, options opts)
+    : ctx_{ ctx }
+    , renderer_{ renderer }
+    , jobs_{ jobs }
+    , opts_{ opts }
+{
+    pool_ = ctx_->device()->vk().createCommandPoolUnique(
+        { vk::CommandPoolCreateFlagBits::eTransient,
+            ctx_->device()->queue().graphics_index },
+        ctx_->device()->callbacks(vk::ObjectType::eCommandPool));
+
+    staging_ = ctx_->memory()->pool(
+        vk::BufferUsageFlagBits::eTransferSrc, VMA_MEMORY_USAGE_CPU_ONLY);
+}
+
+texture_streamer::~texture_streamer()
+{
+    // Decode jobs capture `this`, wait for them before tearing down
+    jobs_->wait(decoding_);
+
+    for (auto& upload : uploads_) {
+        std::ignore = ctx_->device()->vk().waitForFences(upload.fence, true, UINT64_MAX);
+        finish(upload);
+    }
+}
+
+texture_streamer::handle texture_streamer::stream(str_ref path, bool srgb)
+{
+    const str key{ path };
+
+    if (auto it = paths_.find(key); it != paths_.end())
+        return it->second;
+
+    const auto id = handle(entries_.size());
+
+    auto e = make_uptr<entry>();
+    e->path = key;
+    e->format = srgb ? vk::Format::eR8G8B8A8Srgb : vk::Format::eR8G8B8A8Unorm;
+
+    entries_.push_back(std::move(e));
+    paths_[key] = id;
+
+    jobs_->run([this, id, key]() { decode(id, key, ~0u, ~0u); }, &decoding_);
+
+    return id;
+}
+
+void texture_streamer::request(handle id, f32 screen_size)
+{
+    auto& e = *entries_[id];
+
+    e.wanted_size = std::max(e.wanted_size, screen_size);
+    e.last_used = tick_;
+}
+
+texture* texture_streamer::get(handle id) const
+{
+    const auto& e = *entries_[id];
+    return e.detail ? e.detail.get() : e.base.get();
+}
+
+u32 texture_streamer::resident_mip(handle id) const
+{
+    const auto& e = *entries_[id];
+    return e.detail ? e.detail_mip : e.base ? e.base_mip : ~0u;
+}
+
+void texture_streamer::update()
+{
+    const auto device = ctx_->device()->vk();
+
+    std::erase_if(uploads_, [&](upload& upload) {
+        if (device.getFenceStatus(upload.fence) != vk::Result::eSuccess)
+            return false;
+
+        finish(upload);
+        return true;
+    });
+
+    vector<decoded> batch;
+    {
+        std::lock_guard lock{ mutex_ };
+        batch.swap(decoded_);
+    }
+
+    for (auto& d : batch) {
+        auto& e = *entries_[d.id];
+
+        if (d.levels.empty()) {
+            // Give back what the failed detail decode had reserved
+            if (e.base) {
+                stats_.resident -= bytes(e, d.mip);
+            }
+            e.pending = false;
+            continue;
+        }
+
+        // Freshly decoded textures start out with just their base mip
+        if (!e.base) {
+            e.width = d.width;
+            e.height = d.height;
+            e.mips = texture::mip_count(d.width, d.height);
+            e.base_mip = d.mip;
+            e.tail = std::move(d.levels);
+
+            stats_.resident += bytes(e, e.base_mip);
+            schedule(d.id, e.base_mip, {});
+            continue;
+        }
+
+        schedule(d.id, d.mip, std::move(d.levels));
+    }
+
+    stats_.budget = budget();
+
+    // Refine the textures requested this frame, the blurriest ones first
+    struct candidate
+    {
+        handle id;
+        u32 mip;
+        u32 deficit;
+    };
+
+    vector<candidate> candidates;
+
+    for (handle id = 0; id < entries_.size(); id++) {
+        auto& e = *entries_[id];
+
+        if (!e.base || e.pending || e.last_used != tick_)
+            continue;
+
+        const auto current = e.detail ? e.detail_mip : e.base_mip;
+        const auto mip = wanted_mip(e);
+
+        if (mip < current) {
+            candidates.push_back({ id, mip, current - mip });
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const candidate& a, const candidate& b) { return a.deficit > b.deficit; });
+
+    u32 count{ 0 };
+    vk::DeviceSize uploaded{ 0 };
+
+    for (auto& c : candidates) {
+        if (count >= opts_.max_uploads)
+            break;
+
+        auto& e = *entries_[c.id];
+        const auto current = e.detail ? e.detail_mip : e.base_mip;
+
+        // Settle for a coarser mip when the wanted one doesn't fit the budget
+        auto mip = c.mip;
+        while (mip < current && !evict_until(bytes(e, mip))) {
+            mip++;
+        }
+
+        if (mip >= current)
+            continue;
+
+        const auto size = bytes(e, mip);
+
+        if (count > 0 && uploaded + size > opts_.max_upload_bytes)
+            break;
+
+        // Reserved now so later candidates see the budget this one will take
+        e.pending = true;
+        stats_.resident += size;
+
+        jobs_->run(
+            [this, id = c.id, path = e.path, mip, end = e.base_mip]() {
+                decode(id, path, mip, end);
+            },
+            &decoding_);
+
+        uploaded += size;
+        count++;
+    }
+
+    for (auto& e : entries_) {
+        e->wanted_size = 0.f;
+    }
+
+    tick_++;
+    stats_.uploads = u32(uploads_.size());
+}
+
+void texture_streamer::decode(handle id, str path, u32 first, u32 end)
+{
+    i32 w, h;
+    auto pixels = stbi_load(path.c_str(), &w, &h, nullptr, 4);
+
+    if (!pixels) {
+        debug::err("Failed to load texture %s: %s", path.c_str(), stbi_failure_reason());
+
+        std::lock_guard lock{ mutex_ };
+        decoded_.push_back({ id, first, 0, 0, {} });
+        return;
+    }
+
+    decoded result{ id, first, u32(w), u32(h), {} };
+
+    level current{ u32(w), u32(h),
+        vector<uc8>(pixels, pixels + size_t(w) * size_t(h) * 4) };
+    stbi_image_free(pixels);
+
+    // The first decode keeps the base levels, later ones the detail levels above them
+    if (first == ~0u) {
+        result.mip = first = base_level(result.width, result.height);
+    }
+
+    const auto last = std::min(end, texture::mip_count(result.width, result.height));
+
+    // Only the level being filtered & the kept ones are alive at any time
+    for (u32 i = 0; i < last; i++) {
+        auto next = i + 1 < last ? downsample(current) : level{};
+
+        if (i >= first) {
+            result.levels.push_back(std::move(current));
+        }
+
+        current = std::move(next);
+    }
+
+    std::lock_guard lock{ mutex_ };
+    decoded_.push_back(std::move(result));
+}
+
+bool texture_streamer::schedule(handle id, u32 mip, vector<level> detail)
+{
+    const auto device = ctx_->device()->vk();
+
+    auto& e = *entries_[id];
+    const auto size = bytes(e, mip);
+
+    // Levels are packed back to back, every level size is a multiple of the texel size
+    auto staging = staging_->allocate(size);
+
+    if (!staging.valid()) {
+        debug::err("Failed to allocate %llu staging bytes for %s", u64(size),
+            e.path.c_str());
+
+        stats_.resident -= size;
+        e.pending = false;
+        return false;
+    }
+
+    vector<vk::DeviceSize> offsets;
+    vk::DeviceSize offset{ 0 };
+
+    auto copy = [&](const level& l) {
+        std::memcpy(static_cast<uc8*>(staging.mapped) + offset, l.pixels.data(),
+            l.pixels.size());
+        offsets.push_back(staging.offset + offset);
+        offset += l.pixels.size();
+    };
+
+    for (const auto& l : detail) {
+        copy(l);
+    }
+
+    for (const auto& l : e.tail) {
+        copy(l);
+    }
+
+    // Detail pixels are in staging memory now, nothing keeps them around
+    detail = {};
+
+    auto target = std::make_shared<texture>(ctx_);
+    target->create({ std::max(e.width >> mip, 1u), std::max(e.height >> mip, 1u),
+        e.mips - mip, e.format });
+
+    auto cmd = device.allocateCommandBuffers(
+        { pool_.get(), vk::CommandBufferLevel::ePrimary, 1 })[0];
+
+    cmd.begin({ vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    target->record_levels(cmd, staging.buffer, offsets);
+    cmd.end();
+
+    auto fence =
+        device.createFence({}, ctx_->device()->callbacks(vk::ObjectType::eFence));
+
+    vk::SubmitInfo submit_info;
+    submit_info.setCommandBufferCount(1);
+    submit_info.setPCommandBuffers(&cmd);
+    ctx_->device()->queue().submit(submit_info, fence);
+
+    e.pending = true;
+
+    uploads_.push_back({ id, mip, std::move(target), staging, cmd, fence });
+    return true;
+}
+
+void texture_streamer::finish(upload& upload)
+{
+    const auto device = ctx_->device()->vk();
+
+    staging_->free(upload.staging);
+    device.freeCommandBuffers(pool_.get(), upload.cmd);
+    device.destroyFence(upload.fence, ctx_->device()->callbacks(vk::ObjectType::eFence));
+
+    upload.target->status_.store(texture::status::ready, std::memory_order_release);
+
+    auto& e = *entries_[upload.id];
+    e.pending = false;
+
+    if (!e.base) {
+        e.base = std::move(upload.target);
+        return;
+    }
+
+    // Replaced images go through the deletion queue, frames in flight may sample them
+    if (e.detail) {
+        stats_.resident -= bytes(e, e.detail_mip);
+    }
+
+    e.detail = std::move(upload.target);
+    e.detail_mip = upload.mip;
+}
+
+bool texture_streamer::evict_until(vk::DeviceSize needed)
+{
+    const auto limit = stats_.budget;
+
+    if (stats_.resident + needed <= limit)
+        return true;
+
+    // Only detail images that weren't requested this frame are evictable
+    vector<entry*> victims;
+    vk::DeviceSize evictable{ 0 };
+
+    for (auto& e : entries_) {
+        if (e->detail && !e->pending && e->last_used != tick_) {
+            victims.push_back(e.get());
+            evictable += bytes(*e, e->detail_mip);
+        }
+    }
+
+    if (stats_.resident - evictable + needed > limit)
+        return false;
+
+    std::sort(victims.begin(), victims.end(),
+        [](const entry* a, const entry* b) { return a->last_used < b->last_used; });
+
+    for (auto* e : victims) {
+        if (stats_.resident + needed <= limit)
+            break;
+
+        stats_.resident -= bytes(*e, e->detail_mip);
+        e->detail.reset();
+
+        e->detail_mip = ~0u;
+        stats_.evictions++;
+    }
+
+    return true;
+}
+
+vk::DeviceSize texture_streamer::bytes(const entry& e, u32 mip) const
+{
+    vk::DeviceSize size{ 0 };
+    for (auto i = mip; i < e.mips; i++) {
+        const auto w = std::max(e.width >> i, 1u);
+        const auto h = std::max(e.height >> i, 1u);
+        size += vk::DeviceSize(w) * h * 4;
+    }
+    return size;
+}
+
+u32 texture_streamer::base_level(u32 width, u32 height) const
+{
+    const auto count = texture::mip_count(width, height);
+
+    for (u32 i = 0; i < count; i++) {
+        if (std::max({ width >> i, height >> i, 1u }) <= opts_.base_size)
+            return i;
+    }
+
+    return count - 1;
+}
+
+u32 texture_streamer::wanted_mip(const entry& e) const
+{
+    const auto last = e.mips - 1;
+
+    if (e.wanted_size <= 0.f)
+        return last;
+
+    const auto extent = f32(std::max(e.width, e.height));
+    const auto mip = std::floor(std::log2(extent / e.wanted_size));
+
+    return u32(std::clamp(mip, 0.f, f32(last)));
+}
+
+vk::DeviceSize texture_streamer::budget() const
+{
+    if (opts_.budget > 0)
+        return opts_.budget;
+
+    // Our own images are part of the used memory, count them back in
+    const auto available = ctx_->memory()->available() + stats_.resident;
+    return vk::DeviceSize(f64(available) * opts_.budget_fraction);
+}
+} // namespace bnr
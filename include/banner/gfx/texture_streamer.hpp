@@ -0,0 +1,165 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+
+#include <banner/core/jobs.hpp>
+#include <banner/core/types.hpp>
+#include <banner/gfx/buffer_pool.hpp>
+#include <banner/gfx/res/texture.hpp>
+#include <vulkan/vulkan.hpp>
+
+namespace bnr {
+struct graphics;
+struct renderer;
+
+/**
+ * @brief Streams textures at the mip level their on-screen size demands.
+ *
+ * Every texture keeps a small base image (the first mip no larger than
+ * `options::base_size`) resident, and an optional detail image starting at the
+ * requested mip. Detail images are kept within a budget taken from `bnr::memory`, the
+ * least recently requested ones are evicted first.
+ *
+ * Only the base levels stay in system memory. Detail levels are decoded from disk
+ * again on a worker thread whenever they're requested & dropped once uploaded, so a
+ * texture set larger than device memory doesn't have to fit in system memory either.
+ */
+struct texture_streamer
+{
+    using handle = u32;
+
+    static constexpr handle invalid = ~0u;
+
+    struct options
+    {
+        // Fixed residency budget, 0 derives it from the remaining device memory
+        vk::DeviceSize budget{ 0 };
+        f32 budget_fraction{ 0.5f };
+
+        u32 base_size{ 64 };
+        u32 max_uploads{ 4 };
+        vk::DeviceSize max_upload_bytes{ 32 * 1024 * 1024 };
+    };
+
+    struct statistics
+    {
+        vk::DeviceSize resident{ 0 };
+        vk::DeviceSize budget{ 0 };
+        u32 uploads{ 0 };
+        u64 evictions{ 0 };
+    };
+
+    explicit texture_streamer(
+        graphics* ctx, renderer* renderer, bnr::jobs* jobs, options opts);
+    ~texture_streamer();
+
+    handle stream(str_ref path, bool srgb = true);
+
+    /**
+     * @brief Requests the detail needed to draw the texture this frame, `screen_size`
+     * is the projected size of its largest dimension in pixels.
+     */
+    void request(handle id, f32 screen_size);
+
+    /**
+     * @brief Most detailed resident image, null until the base mip is uploaded.
+     */
+    texture* get(handle id) const;
+
+    /**
+     * @brief Most detailed resident mip level, `~0u` while nothing is resident.
+     */
+    u32 resident_mip(handle id) const;
+
+    /**
+     * @brief Applies this frame's requests, called once per frame from the main
+     * thread.
+     */
+    void update();
+
+    auto& opts() { return opts_; }
+    const auto& stats() const { return stats_; }
+
+private:
+    struct level
+    {
+        u32 width;
+        u32 height;
+        vector<uc8> pixels;
+    };
+
+    struct entry
+    {
+        str path;
+        vk::Format format;
+
+        u32 width{ 0 };
+        u32 height{ 0 };
+        u32 mips{ 0 };
+
+        // Levels from `base_mip` on, the only ones kept in system memory
+        vector<level> tail;
+        u32 base_mip{ 0 };
+        f32 wanted_size{ 0.f };
+        u64 last_used{ 0 };
+
+        sptr<texture> base;
+        sptr<texture> detail;
+        u32 detail_mip{ ~0u };
+
+        // Decoding or uploading detail, its bytes are already counted as resident
+        bool pending{ false };
+    };
+
+    struct decoded
+    {
+        handle id;
+        u32 mip;
+        u32 width;
+        u32 height;
+        // Starting at `mip`, empty when decoding failed
+        vector<level> levels;
+    };
+
+    struct upload
+    {
+        handle id;
+        u32 mip;
+        sptr<texture> target;
+        buffer_pool::slice staging;
+        vk::CommandBuffer cmd;
+        vk::Fence fence;
+    };
+
+    void decode(handle id, str path, u32 first, u32 end);
+    bool schedule(handle id, u32 mip, vector<level> detail);
+    void finish(upload& upload);
+
+    u32 base_level(u32 width, u32 height) const;
+
+    bool evict_until(vk::DeviceSize needed);
+    vk::DeviceSize bytes(const entry& e, u32 mip) const;
+    u32 wanted_mip(const entry& e) const;
+    vk::DeviceSize budget() const;
+
+    graphics* ctx_;
+    renderer* renderer_;
+    bnr::jobs* jobs_;
+    options opts_;
+
+    vk::UniqueCommandPool pool_;
+    buffer_pool* staging_;
+
+    vector<uptr<entry>> entries_;
+    std::unordered_map<str, handle> paths_;
+    vector<upload> uploads_;
+
+    std::mutex mutex_;
+    vector<decoded> decoded_;
+    jobs::counter decoding_;
+
+    u64 tick_{ 1 };
+    statistics stats_;
+};
+} // namespace bnr
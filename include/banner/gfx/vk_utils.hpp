@@ -100,7 +100,8 @@ surface_info get_surface_info(
 /**
  *
  */
-vk::ShaderModule load_shader(str_ref filename, vk::Device* device);
+vk::ShaderModule load_shader(str_ref filename, vk::Device* device,
+    const vk::AllocationCallbacks* callbacks = nullptr);
 
 /**
  *
@@ -38,14 +38,58 @@ void window::create_window(str_ref title, vec2 size)
     glfwSetWindowUserPointer(glfw_, this);
 
     // Event handling
+    i32 width, height;
+    glfwGetFramebufferSize(glfw_, &width, &height);
+    framebuffer_ = u32(width) << 16 | u32(height);
+    minimized_ = is_attri_set(GLFW_ICONIFIED);
+    focused_ = is_attri_set(GLFW_FOCUSED);
+
     glfwSetFramebufferSizeCallback(glfw_, [](window_inner* wnd, i32 w, i32 h) {
         auto window = to_window(wnd);
 
         if (!window)
             return;
 
+        window->framebuffer_ = u32(w) << 16 | u32(h);
         window->update_viewport_ = true;
     });
+
+    glfwSetWindowIconifyCallback(glfw_, [](window_inner* wnd, i32 iconified) {
+        if (auto window = to_window(wnd))
+            window->minimized_ = iconified == GLFW_TRUE;
+    });
+
+    glfwSetWindowFocusCallback(glfw_, [](window_inner* wnd, i32 focused) {
+        if (auto window = to_window(wnd))
+            window->focused_ = focused == GLFW_TRUE;
+    });
+
+    glfwSetKeyCallback(
+        glfw_, [](window_inner* wnd, i32 key, i32 scancode, i32 action, i32 mods) {
+            if (auto window = to_window(wnd))
+                window->on_key.fire(key, scancode, action, mods);
+        });
+
+    glfwSetMouseButtonCallback(
+        glfw_, [](window_inner* wnd, i32 button, i32 action, i32 mods) {
+            if (auto window = to_window(wnd))
+                window->on_mouse_button.fire(button, action, mods);
+        });
+
+    glfwSetCursorPosCallback(glfw_, [](window_inner* wnd, f64 x, f64 y) {
+        if (auto window = to_window(wnd))
+            window->on_mouse_move.fire(x, y);
+    });
+
+    glfwSetScrollCallback(glfw_, [](window_inner* wnd, f64 x, f64 y) {
+        if (auto window = to_window(wnd))
+            window->on_scroll.fire(x, y);
+    });
+
+    glfwSetCharCallback(glfw_, [](window_inner* wnd, u32 codepoint) {
+        if (auto window = to_window(wnd))
+            window->on_char.fire(codepoint);
+    });
 }
 
 window::~window()
@@ -62,6 +106,21 @@ void window::handle_events()
     glfwPollEvents();
 }
 
+void window::wait_events(f64 timeout)
+{
+    // A zero timeout would return right away & spin
+    if (timeout > 0.0) {
+        glfwWaitEventsTimeout(timeout);
+    } else {
+        glfwWaitEvents();
+    }
+}
+
+void window::wake()
+{
+    glfwPostEmptyEvent();
+}
+
 void window::render()
 {
     if (!glfw_ || is_minimized()) {
@@ -70,10 +129,9 @@ void window::render()
 
     glfwSwapBuffers(glfw_);
 
-    if (update_viewport_) {
-        update_viewport_ = false;
+    if (update_viewport_.exchange(false)) {
         const auto buffer_size = framebuffer_size();
-        on_resize.fire(u16(buffer_size.x), u16(buffer_size.y));
+        events.fire<"resize">(u16(buffer_size.x), u16(buffer_size.y));
     }
 
     on_render.fire();
@@ -133,7 +191,7 @@ bool window::is_fullscreen() const
 
 bool window::is_minimized() const
 {
-    return is_attri_set(GLFW_ICONIFIED);
+    return minimized_;
 }
 
 bool window::is_maximized() const
@@ -141,6 +199,11 @@ bool window::is_maximized() const
     return is_attri_set(GLFW_MAXIMIZED);
 }
 
+bool window::is_focused() const
+{
+    return focused_;
+}
+
 void window::set_title(str_ref title)
 {
     title_ = title;
@@ -194,15 +257,16 @@ v2 window::mouse_pos() const
 
 vec2 window::framebuffer_size() const
 {
-    f64 w, h;
-    glfwGetFramebufferSize(glfw_, reinterpret_cast<int*>(&w), reinterpret_cast<int*>(&h));
-    return { w, h };
+    const u32 size = framebuffer_;
+    return vec2(size >> 16, size & 0xffff);
 }
 
-vk::SurfaceKHR window::create_surface(vk::Instance instance) const
+vk::SurfaceKHR window::create_surface(
+    vk::Instance instance, const vk::AllocationCallbacks* callbacks) const
 {
     VkSurfaceKHR surface{ nullptr };
-    VULKAN_CHECK(vk::Result(glfwCreateWindowSurface(instance, glfw_, nullptr, &surface)));
+    VULKAN_CHECK(vk::Result(glfwCreateWindowSurface(instance, glfw_,
+        reinterpret_cast<const VkAllocationCallbacks*>(callbacks), &surface)));
     return static_cast<vk::SurfaceKHR>(surface);
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
 #include <banner/core/types.hpp>
+#include <banner/util/event.hpp>
 #include <banner/util/signal.hpp>
 #include <vulkan/vulkan.hpp>
 
@@ -11,6 +13,11 @@ struct GLFWwindow;
 struct GLFWmonitor;
 
 namespace bnr {
+/**
+ * @brief glfw window. Events have to be pumped on the main thread, the engine loop
+ * runs on its own one & only uses `render`, `should_close`, `wake` & the state the
+ * callbacks cache (minimized, focused & framebuffer size).
+ */
 struct window
 {
     using window_inner = GLFWwindow;
@@ -44,18 +51,39 @@ struct window
 
     bool is_minimized() const;
     bool is_maximized() const;
+    bool is_focused() const;
 
     void render();
     void handle_events();
 
+    /**
+     * @brief Makes a pending `wait_events` return, callable from any thread.
+     */
+    void wake();
+
+    /**
+     * @brief Blocks until an event arrives or `timeout` seconds passed, a timeout of 0
+     * waits for the next event only.
+     */
+    void wait_events(f64 timeout);
+
     bool should_close() const;
 
-    vk::SurfaceKHR create_surface(vk::Instance) const;
+    vk::SurfaceKHR create_surface(
+        vk::Instance, const vk::AllocationCallbacks* callbacks = nullptr) const;
     vector<cstr> get_instance_ext() const;
 
-    signal<void(u16, u16)> on_resize;
+    // "resize": framebuffer size after a resize, fired before the next render
+    event_bus<event<"resize", void(u16, u16)>> events;
     signal<void()> on_render;
 
+    // Fired from `handle_events`, raw glfw key/button/action/mod values
+    signal<void(i32 key, i32 scancode, i32 action, i32 mods)> on_key;
+    signal<void(i32 button, i32 action, i32 mods)> on_mouse_button;
+    signal<void(f64 x, f64 y)> on_mouse_move;
+    signal<void(f64 x, f64 y)> on_scroll;
+    signal<void(u32 codepoint)> on_char;
+
 private:
     void create_window(str_ref title, vec2 size);
 
@@ -66,9 +94,14 @@ private:
 
     str title_;
 
-    bool update_viewport_{ false };
+    std::atomic<bool> update_viewport_{ false };
     bool fullscreen_{ false };
 
+    // Written by the event callbacks, read from the engine loop
+    std::atomic<bool> minimized_{ false };
+    std::atomic<bool> focused_{ false };
+    std::atomic<u32> framebuffer_{ 0 };
+
     window_inner* glfw_{ nullptr };
     window_monitor* monitor_{ nullptr };
 };
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief String literal usable as a template argument, events are named with it.
+ */
+template<size_t N>
+struct fixed_string
+{
+    char value[N]{};
+
+    constexpr fixed_string(const char (&str)[N]) { std::copy_n(str, N, value); }
+
+    template<size_t M>
+    constexpr bool operator==(const fixed_string<M>& other) const
+    {
+        if constexpr (N != M) {
+            return false;
+        } else {
+            return std::equal(value, value + N, other.value);
+        }
+    }
+};
+
+/**
+ * @brief Callback stored inline, a member function bound to an instance or a functor
+ * of at most `Size` bytes. Never allocates.
+ */
+template<typename Signature, size_t Size = 3 * sizeof(void*)>
+struct delegate;
+
+template<typename... Args, size_t Size>
+struct delegate<void(Args...), Size>
+{
+    delegate() = default;
+    ~delegate() { reset(); }
+
+    delegate(const delegate&) = delete;
+    delegate& operator=(const delegate&) = delete;
+
+    template<auto Method, typename T>
+    void bind(T& instance)
+    {
+        reset();
+        new (storage_) T*{ &instance };
+        invoke_ = &call_method<Method, T>;
+    }
+
+    template<typename F>
+    void bind(F&& f)
+    {
+        using functor = std::decay_t<F>;
+
+        static_assert(sizeof(functor) <= Size && alignof(functor) <= alignof(void*),
+            "Callback doesn't fit in the inline storage");
+
+        reset();
+        new (storage_) functor(std::forward<F>(f));
+        invoke_ = &call_functor<functor>;
+
+        if constexpr (!std::is_trivially_destructible_v<functor>) {
+            destroy_ = [](void* s) { static_cast<functor*>(s)->~functor(); };
+        }
+    }
+
+    template<auto Method, typename T>
+    bool bound_to(const T& instance) const
+    {
+        return invoke_ == &call_method<Method, T> &&
+            *std::launder(reinterpret_cast<T* const*>(storage_)) == &instance;
+    }
+
+    void reset()
+    {
+        if (destroy_) {
+            destroy_(storage_);
+        }
+
+        invoke_ = nullptr;
+        destroy_ = nullptr;
+    }
+
+    explicit operator bool() const { return invoke_ != nullptr; }
+
+    void operator()(Args... args) { invoke_(storage_, args...); }
+
+private:
+    template<auto Method, typename T>
+    static void call_method(void* s, Args... args)
+    {
+        (*std::launder(static_cast<T**>(s))->*Method)(args...);
+    }
+
+    template<typename F>
+    static void call_functor(void* s, Args... args)
+    {
+        (*std::launder(static_cast<F*>(s)))(args...);
+    }
+
+    alignas(void*) uc8 storage_[Size];
+    void (*invoke_)(void*, Args...){ nullptr };
+    void (*destroy_)(void*){ nullptr };
+};
+
+/**
+ * @brief Declares an event for `event_bus`, `Slots` callbacks can be connected and
+ * `Pending` calls can be queued, both stored inline.
+ */
+template<fixed_string Name, typename Signature, u32 Slots = 8, u32 Pending = 16>
+struct event;
+
+template<fixed_string Name, typename... Args, u32 Slots, u32 Pending>
+struct event<Name, void(Args...), Slots, Pending>
+{
+    static constexpr auto name = Name;
+
+    using callback = delegate<void(Args...)>;
+    using arguments = std::tuple<std::decay_t<Args>...>;
+
+    std::array<callback, Slots> slots;
+    // Slots past the last connected one are always empty
+    u32 used{ 0 };
+
+    std::array<arguments, Pending> pending;
+    u32 queued{ 0 };
+};
+
+/**
+ * @brief Signals resolved at compile time, `fire<"resize">(w, h)` indexes straight
+ * into the event's slots without any lookup or allocation. Calls can also be queued
+ * with `queue` & delivered in one batch by `dispatch`.
+ *
+ *   event_bus<event<"resize", void(u16, u16)>, event<"created", void()>> events;
+ *   events.on<"resize", &graphics::resize>(*this);
+ *   events.on<"created">([]() {});
+ *
+ * Callbacks are called in slot order, connecting or disconnecting while the same
+ * event fires isn't supported. Not thread safe.
+ */
+template<typename... Events>
+struct event_bus
+{
+    event_bus() = default;
+
+    event_bus(const event_bus&) = delete;
+    event_bus& operator=(const event_bus&) = delete;
+
+    /**
+     * @brief Connects `Method` of `instance`, returns false when all slots are used.
+     */
+    template<fixed_string Name, auto Method, typename T>
+    bool on(T& instance)
+    {
+        auto slot = free_slot(get<Name>());
+        if (slot) {
+            slot->template bind<Method>(instance);
+        }
+        return slot != nullptr;
+    }
+
+    template<fixed_string Name, typename F>
+    bool on(F&& f)
+    {
+        auto slot = free_slot(get<Name>());
+        if (slot) {
+            slot->bind(std::forward<F>(f));
+        }
+        return slot != nullptr;
+    }
+
+    template<fixed_string Name, auto Method, typename T>
+    void off(const T& instance)
+    {
+        auto& e = get<Name>();
+
+        for (u32 i = 0; i < e.used; i++) {
+            if (e.slots[i].template bound_to<Method>(instance)) {
+                e.slots[i].reset();
+            }
+        }
+
+        while (e.used > 0 && !e.slots[e.used - 1]) {
+            e.used--;
+        }
+    }
+
+    /**
+     * @brief Disconnects every callback of `Name`, functors included.
+     */
+    template<fixed_string Name>
+    void clear()
+    {
+        auto& e = get<Name>();
+
+        for (u32 i = 0; i < e.used; i++) {
+            e.slots[i].reset();
+        }
+        e.used = 0;
+    }
+
+    template<fixed_string Name, typename... A>
+    void fire(A&&... args)
+    {
+        auto& e = get<Name>();
+
+        for (u32 i = 0; i < e.used; i++) {
+            if (e.slots[i]) {
+                e.slots[i](args...);
+            }
+        }
+    }
+
+    /**
+     * @brief Stores the call until the next `dispatch`, returns false when the queue
+     * of `Name` is full.
+     */
+    template<fixed_string Name, typename... A>
+    bool queue(A&&... args)
+    {
+        auto& e = get<Name>();
+
+        if (e.queued == e.pending.size())
+            return false;
+
+        e.pending[e.queued++] = { std::forward<A>(args)... };
+        return true;
+    }
+
+    /**
+     * @brief Fires every queued call, event by event in declaration order. Calls
+     * queued by the callbacks wait for the next dispatch.
+     */
+    void dispatch() { (deliver(std::get<Events>(events_)), ...); }
+
+    template<fixed_string Name>
+    u32 connected() const
+    {
+        const auto& e = std::get<index<Name>()>(events_);
+        return u32(std::count_if(e.slots.begin(), e.slots.begin() + e.used,
+            [](const auto& slot) { return bool(slot); }));
+    }
+
+    template<fixed_string Name>
+    u32 queued() const
+    {
+        return std::get<index<Name>()>(events_).queued;
+    }
+
+private:
+    template<fixed_string Name>
+    static constexpr size_t index()
+    {
+        constexpr std::array<bool, sizeof...(Events)> matches{
+            (Events::name == Name)...
+        };
+
+        static_assert(std::count(matches.begin(), matches.end(), true) == 1,
+            "Event isn't declared exactly once in this bus");
+
+        return size_t(std::find(matches.begin(), matches.end(), true) - matches.begin());
+    }
+
+    template<fixed_string Name>
+    auto& get()
+    {
+        return std::get<index<Name>()>(events_);
+    }
+
+    template<typename E>
+    static typename E::callback* free_slot(E& e)
+    {
+        for (u32 i = 0; i < e.slots.size(); i++) {
+            if (!e.slots[i]) {
+                e.used = std::max(e.used, i + 1);
+                return &e.slots[i];
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename E>
+    static void deliver(E& e)
+    {
+        const auto count = e.queued;
+
+        for (u32 i = 0; i < count; i++) {
+            std::apply(
+                [&](auto&... args) {
+                    for (u32 s = 0; s < e.used; s++) {
+                        if (e.slots[s]) {
+                            e.slots[s](args...);
+                        }
+                    }
+                },
+                e.pending[i]);
+        }
+
+        // Keep what the callbacks queued meanwhile
+        std::move(e.pending.begin() + count, e.pending.begin() + e.queued,
+            e.pending.begin());
+        e.queued -= count;
+    }
+
+    std::tuple<Events...> events_;
+};
+} // namespace bnr
@@ -1,8 +1,19 @@
 #include <fstream>
 
+#include <banner/defs.hpp>
 #include <banner/util/debug.hpp>
 #include <banner/util/file.hpp>
 
+#ifdef TARGET_WIN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace bnr {
 vector<char> read_file(str_ref filename)
 {
@@ -23,4 +34,68 @@ vector<char> read_file(str_ref filename)
     file.close();
     return buffer;
 }
+
+#ifdef TARGET_WIN
+mapped_file::mapped_file(str_ref filename)
+{
+    file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file_ == INVALID_HANDLE_VALUE) {
+        file_ = nullptr;
+        debug::err("Failed to map file: %s", filename.c_str());
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+        return;
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_)
+        return;
+
+    data_ = static_cast<const uc8*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    size_ = data_ ? u64(size.QuadPart) : 0;
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_)
+        CloseHandle(mapping_);
+    if (file_)
+        CloseHandle(file_);
+}
+#else
+mapped_file::mapped_file(str_ref filename)
+{
+    const auto fd = open(filename.c_str(), O_RDONLY);
+
+    if (fd < 0) {
+        debug::err("Failed to map file: %s", filename.c_str());
+        return;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        auto view = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (view != MAP_FAILED) {
+            data_ = static_cast<const uc8*>(view);
+            size_ = u64(info.st_size);
+        }
+    }
+
+    // The mapping keeps the file alive
+    close(fd);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_)
+        munmap(const_cast<uc8*>(data_), size_t(size_));
+}
+#endif
 } // namespace bnr
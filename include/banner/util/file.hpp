@@ -1,6 +1,35 @@
+#pragma once
+
 #include <banner/core/types.hpp>
+#include <banner/defs.hpp>
 #include <vector>
 
 namespace bnr {
 vector<char> read_file(str_ref filename);
+
+/**
+ * @brief Read only memory mapping of a whole file, `data` is null if it couldn't be
+ * opened. The mapping is page aligned.
+ */
+struct mapped_file
+{
+    explicit mapped_file(str_ref filename);
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    const uc8* data() const { return data_; }
+    u64 size() const { return size_; }
+    bool valid() const { return data_ != nullptr; }
+
+private:
+    const uc8* data_{ nullptr };
+    u64 size_{ 0 };
+
+#ifdef TARGET_WIN
+    void* file_{ nullptr };
+    void* mapping_{ nullptr };
+#endif
+};
 } // namespace bnr
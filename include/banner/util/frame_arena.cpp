@@ -0,0 +1,52 @@
+#include <algorithm>
+
+#include <banner/util/frame_arena.hpp>
+
+namespace bnr {
+frame_arena::frame_arena(u64 capacity)
+{
+    grow(capacity);
+}
+
+void* frame_arena::allocate(u64 size, u64 alignment)
+{
+    auto align = [&](u64 offset) {
+        const auto base = reinterpret_cast<u64>(blocks_.back().data.get());
+        return ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+    };
+
+    auto offset = align(offset_);
+
+    if (offset + size > blocks_.back().size) {
+        grow(std::max(size + alignment, blocks_.back().size));
+        offset = align(0);
+    }
+
+    offset_ = offset + size;
+    used_ += size;
+
+    return blocks_.back().data.get() + offset;
+}
+
+void frame_arena::reset()
+{
+    // Size the arena for the worst frame so far, so it stops chaining blocks
+    if (blocks_.size() > 1) {
+        const auto total = capacity_;
+
+        blocks_.clear();
+        capacity_ = 0;
+        grow(total);
+    }
+
+    offset_ = 0;
+    used_ = 0;
+}
+
+void frame_arena::grow(u64 size)
+{
+    blocks_.push_back({ make_uptr<uc8[]>(size), size });
+    capacity_ += size;
+    offset_ = 0;
+}
+} // namespace bnr
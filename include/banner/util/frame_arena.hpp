@@ -0,0 +1,54 @@
+#pragma once
+
+#include <type_traits>
+
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief Linear allocator for data that only lives for a single frame. Allocations
+ * bump a pointer and are released all at once by `reset`, when a frame outgrows the
+ * arena extra blocks are chained and merged into one on the next reset.
+ */
+struct frame_arena
+{
+    static constexpr u64 default_capacity = 1024 * 1024;
+
+    explicit frame_arena(u64 capacity = default_capacity);
+
+    frame_arena(const frame_arena&) = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+
+    /**
+     * @brief Returns uninitialized memory, alignment has to be a power of two.
+     */
+    void* allocate(u64 size, u64 alignment);
+
+    template<typename T>
+    T* allocate(u32 count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>,
+            "Arena memory is released without calling destructors");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    void reset();
+
+    u64 used() const { return used_; }
+    u64 capacity() const { return capacity_; }
+
+private:
+    struct block
+    {
+        uptr<uc8[]> data;
+        u64 size;
+    };
+
+    void grow(u64 size);
+
+    vector<block> blocks_;
+    u64 offset_{ 0 };
+    u64 used_{ 0 };
+    u64 capacity_{ 0 };
+};
+} // namespace bnr
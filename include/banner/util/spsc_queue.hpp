@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief Bounded lock free queue for exactly one producer & one consumer thread. The
+ * capacity is rounded up to a power of two, `push` fails instead of blocking when the
+ * queue is full.
+ */
+template<typename T>
+struct spsc_queue
+{
+    explicit spsc_queue(u32 capacity)
+    {
+        u32 size{ 2 };
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        items_.resize(size);
+        mask_ = size - 1;
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    /**
+     * @brief Producer only.
+     */
+    bool push(const T& item)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+
+        if (tail - head_cache_ > mask_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ > mask_)
+                return false;
+        }
+
+        items_[tail & mask_] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer only, the oldest item or null when empty.
+     */
+    const T* peek()
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return nullptr;
+        }
+
+        return &items_[head & mask_];
+    }
+
+    /**
+     * @brief Consumer only, drops the item returned by `peek`.
+     */
+    void pop()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& item)
+    {
+        const auto front = peek();
+        if (!front)
+            return false;
+
+        item = *front;
+        pop();
+        return true;
+    }
+
+    u32 capacity() const { return mask_ + 1; }
+
+private:
+    vector<T> items_;
+    u32 mask_{ 0 };
+
+    // Indices only grow & wrap around, each side caches the other's to avoid sharing
+    alignas(64) std::atomic<u32> head_{ 0 };
+    u32 tail_cache_{ 0 };
+
+    alignas(64) std::atomic<u32> tail_{ 0 };
+    u32 head_cache_{ 0 };
+};
+} // namespace bnr
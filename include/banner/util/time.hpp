@@ -12,6 +12,7 @@ using time_point = clock::time_point;
 
 using sec = std::chrono::seconds;
 using ms = std::chrono::milliseconds;
+using us = std::chrono::microseconds;
 
 struct timer final
 {
@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <bit>
+
+#include <banner/util/tlsf.hpp>
+
+namespace bnr {
+namespace {
+inline u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+} // namespace
+
+tlsf::tlsf(u64 size)
+    : capacity_{ size & ~(min_alignment - 1) }
+{
+    for (auto& fl : heads_) {
+        std::fill(std::begin(fl), std::end(fl), invalid);
+    }
+
+    if (capacity_ < min_alignment)
+        return;
+
+    auto root = make_node();
+    nodes_[root].offset = 0;
+    nodes_[root].size = capacity_;
+    insert_free(root);
+}
+
+tlsf::handle tlsf::allocate(u64 size, u64 alignment, u64& offset)
+{
+    size = align_up(std::max<u64>(size, 1), min_alignment);
+    alignment = std::max(alignment, min_alignment);
+
+    // Over-allocate so the block can always be aligned
+    const auto search = size + alignment - min_alignment;
+    auto found = find_free(search);
+
+    // Rounding up to the next list skips blocks that fit exactly, e.g. a fresh
+    // dedicated block, so look through the list the size itself maps to
+    if (found == invalid) {
+        found = find_fit(size, alignment);
+    }
+
+    if (found == invalid)
+        return invalid;
+
+    remove_free(found);
+
+    const auto aligned = align_up(nodes_[found].offset, alignment);
+    const auto padding = aligned - nodes_[found].offset;
+
+    if (padding > 0) {
+        // Give the leading padding back as its own free range
+        auto front = found;
+        found = split(front, padding);
+        insert_free(front);
+    }
+
+    if (nodes_[found].size - size >= min_alignment) {
+        insert_free(split(found, size));
+    }
+
+    nodes_[found].free = false;
+    used_ += nodes_[found].size;
+    allocations_++;
+
+    offset = nodes_[found].offset;
+    return found;
+}
+
+void tlsf::free(handle node)
+{
+    if (node == invalid || nodes_[node].free)
+        return;
+
+    used_ -= nodes_[node].size;
+    allocations_--;
+
+    nodes_[node].free = true;
+    insert_free(merge(node));
+}
+
+u64 tlsf::largest_free() const
+{
+    if (fl_bitmap_ == 0)
+        return 0;
+
+    const u32 fl = 63 - std::countl_zero(fl_bitmap_);
+    const u32 sl = 31 - std::countl_zero(sl_bitmap_[fl]);
+
+    u64 largest = 0;
+    for (auto n = heads_[fl][sl]; n != invalid; n = nodes_[n].next_free) {
+        largest = std::max(largest, nodes_[n].size);
+    }
+    return largest;
+}
+
+void tlsf::mapping(u64 size, u32& fl, u32& sl)
+{
+    fl = 63 - std::countl_zero(size);
+    sl = u32(size >> (fl - sl_log2)) ^ sl_count;
+}
+
+tlsf::handle tlsf::make_node()
+{
+    if (!unused_nodes_.empty()) {
+        auto n = unused_nodes_.back();
+        unused_nodes_.pop_back();
+        nodes_[n] = {};
+        return n;
+    }
+
+    nodes_.emplace_back();
+    return handle(nodes_.size() - 1);
+}
+
+void tlsf::release_node(handle node)
+{
+    unused_nodes_.push_back(node);
+}
+
+void tlsf::insert_free(handle node)
+{
+    u32 fl, sl;
+    mapping(nodes_[node].size, fl, sl);
+
+    auto& n = nodes_[node];
+    n.free = true;
+    n.prev_free = invalid;
+    n.next_free = heads_[fl][sl];
+
+    if (n.next_free != invalid) {
+        nodes_[n.next_free].prev_free = node;
+    }
+
+    heads_[fl][sl] = node;
+    fl_bitmap_ |= 1ull << fl;
+    sl_bitmap_[fl] |= 1u << sl;
+}
+
+void tlsf::remove_free(handle node)
+{
+    u32 fl, sl;
+    mapping(nodes_[node].size, fl, sl);
+
+    auto& n = nodes_[node];
+
+    if (n.prev_free != invalid) {
+        nodes_[n.prev_free].next_free = n.next_free;
+    } else {
+        heads_[fl][sl] = n.next_free;
+    }
+
+    if (n.next_free != invalid) {
+        nodes_[n.next_free].prev_free = n.prev_free;
+    }
+
+    if (heads_[fl][sl] == invalid) {
+        sl_bitmap_[fl] &= ~(1u << sl);
+        if (sl_bitmap_[fl] == 0) {
+            fl_bitmap_ &= ~(1ull << fl);
+        }
+    }
+
+    n.prev_free = invalid;
+    n.next_free = invalid;
+    n.free = false;
+}
+
+tlsf::handle tlsf::find_free(u64 size) const
+{
+    // Round up to the next list so any block found is large enough
+    u32 fl = 63 - std::countl_zero(size);
+    size += (1ull << (fl - sl_log2)) - 1;
+
+    u32 sl;
+    mapping(size, fl, sl);
+
+    if (fl >= fl_count)
+        return invalid;
+
+    auto sl_map = sl_bitmap_[fl] & (~0u << sl);
+
+    if (sl_map == 0) {
+        const auto fl_map = fl + 1 < 64 ? fl_bitmap_ & (~0ull << (fl + 1)) : 0;
+
+        if (fl_map == 0)
+            return invalid;
+
+        fl = std::countr_zero(fl_map);
+        sl_map = sl_bitmap_[fl];
+    }
+
+    sl = std::countr_zero(sl_map);
+    return heads_[fl][sl];
+}
+
+tlsf::handle tlsf::find_fit(u64 size, u64 alignment) const
+{
+    u32 fl, sl;
+    mapping(size, fl, sl);
+
+    // Only called once `find_free` failed, every list from the rounded up one on is
+    // empty, so this walks the few lists in between
+    for (; fl < fl_count; fl++, sl = 0) {
+        for (auto sl_map = sl_bitmap_[fl] & (~0u << sl); sl_map != 0;
+             sl_map &= sl_map - 1) {
+            const auto list = u32(std::countr_zero(sl_map));
+
+            for (auto n = heads_[fl][list]; n != invalid; n = nodes_[n].next_free) {
+                const auto& candidate = nodes_[n];
+                const auto padding =
+                    align_up(candidate.offset, alignment) - candidate.offset;
+
+                if (candidate.size >= size + padding)
+                    return n;
+            }
+        }
+    }
+
+    return invalid;
+}
+
+tlsf::handle tlsf::split(handle node, u64 size)
+{
+    auto rest = make_node();
+
+    auto& n = nodes_[node];
+    auto& r = nodes_[rest];
+
+    r.offset = n.offset + size;
+    r.size = n.size - size;
+    r.prev_phys = node;
+    r.next_phys = n.next_phys;
+
+    if (r.next_phys != invalid) {
+        nodes_[r.next_phys].prev_phys = rest;
+    }
+
+    n.size = size;
+    n.next_phys = rest;
+
+    return rest;
+}
+
+tlsf::handle tlsf::merge(handle node)
+{
+    auto prev = nodes_[node].prev_phys;
+
+    if (prev != invalid && nodes_[prev].free) {
+        remove_free(prev);
+
+        nodes_[prev].size += nodes_[node].size;
+        nodes_[prev].next_phys = nodes_[node].next_phys;
+
+        if (nodes_[prev].next_phys != invalid) {
+            nodes_[nodes_[prev].next_phys].prev_phys = prev;
+        }
+
+        release_node(node);
+        node = prev;
+    }
+
+    auto next = nodes_[node].next_phys;
+
+    if (next != invalid && nodes_[next].free) {
+        remove_free(next);
+
+        nodes_[node].size += nodes_[next].size;
+        nodes_[node].next_phys = nodes_[next].next_phys;
+
+        if (nodes_[node].next_phys != invalid) {
+            nodes_[nodes_[node].next_phys].prev_phys = node;
+        }
+
+        release_node(next);
+    }
+
+    return node;
+}
+} // namespace bnr
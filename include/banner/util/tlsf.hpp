@@ -0,0 +1,80 @@
+#pragma once
+
+#include <banner/core/types.hpp>
+
+namespace bnr {
+/**
+ * @brief Two-level segregated fit allocator. Only manages offsets into an external
+ * range, so it can be used to sub-allocate gpu buffers & memory.
+ * http://www.gii.upv.es/tlsf/files/papers/ecrts04_tlsf.pdf
+ */
+struct tlsf
+{
+    using handle = u32;
+
+    static constexpr handle invalid = ~0u;
+    static constexpr u64 min_alignment = 16;
+
+    explicit tlsf(u64 size);
+
+    /**
+     * @brief Returns a handle to the allocated range or `invalid`, `offset` is set to
+     * the (aligned) start of the range. Alignment has to be a power of two.
+     */
+    handle allocate(u64 size, u64 alignment, u64& offset);
+    void free(handle node);
+
+    u64 offset(handle node) const { return nodes_[node].offset; }
+    u64 size(handle node) const { return nodes_[node].size; }
+
+    u64 capacity() const { return capacity_; }
+    u64 used() const { return used_; }
+    u32 allocations() const { return allocations_; }
+    bool empty() const { return allocations_ == 0; }
+
+    /**
+     * @brief Size of the largest free range.
+     */
+    u64 largest_free() const;
+
+private:
+    static constexpr u32 sl_log2 = 4;
+    static constexpr u32 sl_count = 1 << sl_log2;
+    static constexpr u32 fl_count = 40;
+
+    struct node
+    {
+        u64 offset{ 0 };
+        u64 size{ 0 };
+        u32 prev_phys{ invalid };
+        u32 next_phys{ invalid };
+        u32 prev_free{ invalid };
+        u32 next_free{ invalid };
+        bool free{ false };
+    };
+
+    static void mapping(u64 size, u32& fl, u32& sl);
+
+    handle make_node();
+    void release_node(handle node);
+
+    void insert_free(handle node);
+    void remove_free(handle node);
+    handle find_free(u64 size) const;
+    handle find_fit(u64 size, u64 alignment) const;
+
+    handle split(handle node, u64 size);
+    handle merge(handle node);
+
+    u64 capacity_{ 0 };
+    u64 used_{ 0 };
+    u32 allocations_{ 0 };
+
+    u64 fl_bitmap_{ 0 };
+    u32 sl_bitmap_[fl_count]{};
+    handle heads_[fl_count][sl_count];
+
+    vector<node> nodes_;
+    vector<handle> unused_nodes_;
+};
+} // namespace bnr